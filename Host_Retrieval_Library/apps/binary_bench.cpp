@@ -0,0 +1,60 @@
+// Binary prefilter + float rerank: recall@k against the float scan for a
+// sweep of candidate counts R. Exits non-zero if keeping every vector as a
+// candidate does not reproduce the float result.
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_set>
+
+#include "binary_codes.h"
+#include "cpu_twin.h"
+#include "synthetic_data.h"
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    const size_t nq = 200;
+    const unsigned dim = 768;
+    const unsigned k = 10;
+    const unsigned words = binary_words(dim);
+
+    std::vector<float> X = make_clustered(n, dim, 1024, 0.04f, 1, 2);
+    std::vector<float> Q = make_clustered(nq, dim, 1024, 0.04f, 1, 3);
+
+    std::vector<uint32_t> codes(n * words), qcodes(nq * words);
+    binary_encode(X.data(), n, dim, codes.data());
+    binary_encode(Q.data(), nq, dim, qcodes.data());
+    std::cout << "corpus " << n << " x " << dim << ": " << dim * sizeof(float) << " B -> "
+              << words * sizeof(uint32_t) << " B per vector" << std::endl;
+
+    std::vector<TopK> truth;
+    twin_score_topk(X.data(), n, Q.data(), nq, dim, k, truth);
+
+    std::cout << "R  recall@" << k << "  QPS" << std::endl;
+    double last = 0.0;
+    for (size_t r = 16; ; r *= 4) {
+        if (r > n) r = n;
+        size_t hit = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < nq; ++q) {
+            TopK cand((unsigned)r), top(k);
+            binary_prefilter(&qcodes[q * words], codes.data(), n, words, cand);
+            binary_rerank(&Q[q * dim], X.data(), dim, cand, top);
+
+            std::unordered_set<int32_t> ids;
+            for (const ScoredId& e : truth[q].items()) ids.insert(e.id);
+            for (const ScoredId& e : top.items()) hit += ids.count(e.id);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        last = (double)hit / (nq * k);
+        std::cout << r << "  " << last << "  "
+                  << nq / std::chrono::duration<double>(t1 - t0).count() << std::endl;
+        if (r == n) break;
+    }
+
+    if (last != 1.0) {
+        std::cout << "full rerank DOES NOT match float scan" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "full rerank matches float scan" << std::endl;
+    return EXIT_SUCCESS;
+}
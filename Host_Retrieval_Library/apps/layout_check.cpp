@@ -0,0 +1,111 @@
+// Checks the C++ tile layout against the Python one and measures it on a
+// large corpus. data_dir (default: the Batched_Query data directory) holds
+// outputc_full_float.txt, written row-major by gen_test_data.py, and
+// ref_outputc_float.txt, the same matrix through mat2file_tile(c, 4, 4).
+// Then every dtype's MMUL tile shapes round-trip, the threaded path matches
+// the serial one, and n x dim floats are tiled into an mmap'd file. Exits
+// non-zero on any mismatch.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tile_layout.h"
+
+static std::vector<float> read_floats(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) {
+        std::cerr << "cannot open " << path << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    std::vector<float> v;
+    float x;
+    while (f >> x) v.push_back(x);
+    return v;
+}
+
+template <typename T>
+static bool round_trip(size_t rows, size_t cols, unsigned R, unsigned C) {
+    std::mt19937 rng(7);
+    std::vector<T> src(rows * cols), a(src.size()), b(src.size()), back(src.size());
+    for (T& v : src) v = (T)(rng() % 127);
+    tile_matrix(src.data(), rows, cols, R, C, a.data());
+    tile_matrix_mt(src.data(), rows, cols, R, C, b.data(), 3);
+    untile_matrix_mt(b.data(), rows, cols, R, C, back.data(), 3);
+    return a == b && back == src;
+}
+
+template <typename T>
+static bool round_trip_mmul(const char* name) {
+    typedef MmulTile<T> S;
+    const bool ok = round_trip<T>(128, 64, S::M, S::K) && round_trip<T>(64, 32, S::K, S::N);
+    std::cout << name << " A " << S::M << "x" << S::K << ", B " << S::K << "x" << S::N << ": "
+              << (ok ? "ok" : "MISMATCH") << std::endl;
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    const std::string dir = argc > 1 ? argv[1] : "../Matrix_Matrix_Multiplication_Batched_Query/data";
+    const size_t n = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 250000;
+    const unsigned dim = 128;
+    bool ok = true;
+
+    // Python layout: C of the batched graph, 128 x 32 in 4 x 4 tiles
+    std::vector<float> full = read_floats(dir + "/outputc_full_float.txt");
+    std::vector<float> ref = read_floats(dir + "/ref_outputc_float.txt");
+    if (full.size() != 128 * 32 || ref.size() != full.size()) {
+        std::cout << "unexpected reference sizes" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::vector<float> tiled(full.size()), back(full.size());
+    tile_matrix(full.data(), 128, 32, 4, 4, tiled.data());
+    untile_matrix(ref.data(), 128, 32, 4, 4, back.data());
+    const bool py = tiled == ref && back == full;
+    std::cout << "mat2file_tile 4x4 reference: " << (py ? "ok" : "MISMATCH") << std::endl;
+    ok = ok && py;
+
+    ok = round_trip_mmul<float>("float") && ok;
+    ok = round_trip_mmul<int32_t>("int32") && ok;
+    ok = round_trip_mmul<int16_t>("int16") && ok;
+    ok = round_trip_mmul<int8_t>("int8") && ok;
+
+    // corpus straight into a mapped file, in 4 x 2 A tiles
+    std::vector<float> X(n * dim);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+    for (float& v : X) v = u(rng);
+    const std::string path = "layout_check.bin";
+    double serialS, mtS;
+    {
+        MappedFile out(path, X.size() * sizeof(float));
+        auto t0 = std::chrono::steady_clock::now();
+        tile_matrix(X.data(), n, dim, 4, 2, out.as<float>());
+        auto t1 = std::chrono::steady_clock::now();
+        tile_matrix_mt(X.data(), n, dim, 4, 2, out.as<float>());
+        auto t2 = std::chrono::steady_clock::now();
+        serialS = std::chrono::duration<double>(t1 - t0).count();
+        mtS = std::chrono::duration<double>(t2 - t1).count();
+
+        // spot check one 128-row block against tiling it alone
+        const size_t blk = n / 128 / 2;
+        std::vector<float> one(128 * dim);
+        tile_matrix(&X[blk * 128 * dim], 128, dim, 4, 2, one.data());
+        const bool same = std::equal(one.begin(), one.end(), out.as<float>() + blk * 128 * dim);
+        std::cout << "corpus block " << blk << " in the mapped file: " << (same ? "ok" : "MISMATCH")
+                  << std::endl;
+        ok = ok && same;
+    }
+    std::remove(path.c_str());
+
+    const double gb = X.size() * sizeof(float) / 1e9;
+    std::cout << n << " x " << dim << " floats: " << gb / serialS << " GB/s serial, " << gb / mtS
+              << " GB/s threaded, " << n / mtS << " vectors/s" << std::endl;
+
+    std::cout << (ok ? "layout matches the Python reference" : "layout DOES NOT match") << std::endl;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
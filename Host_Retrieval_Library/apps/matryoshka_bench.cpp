@@ -0,0 +1,102 @@
+// Matryoshka two-pass search at 768 dimensions: recall@k of a first pass on
+// the leading 64 dimensions plus a full-dim rerank of the top R, for a sweep
+// of R. The first pass keeps MRL_TOPR rows per MRL_ROWS-row block as the
+// scan kernel does, so R stops at that candidate count. Exits non-zero if
+// the scan twin disagrees with a direct slice scan or if reranking every
+// vector without the per-block cap does not reproduce the full scan.
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_set>
+
+#include "cpu_twin.h"
+#include "matryoshka.h"
+#include "synthetic_data.h"
+#include "tile_layout.h"
+
+// Energy decays over the dimensions, as in Matryoshka-trained embeddings
+static void decay(std::vector<float>& X, unsigned dim) {
+    for (size_t i = 0; i < X.size() / dim; ++i) {
+        float s = 0.0f;
+        for (unsigned d = 0; d < dim; ++d) {
+            X[i * dim + d] /= std::sqrt(1.0f + d / 16.0f);
+            s += X[i * dim + d] * X[i * dim + d];
+        }
+        for (unsigned d = 0; d < dim; ++d) X[i * dim + d] /= std::sqrt(s);
+    }
+}
+
+int main(int argc, char** argv) {
+    MatryoshkaShape s;
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    const size_t nq = 100;
+    const unsigned k = 10;
+    bool ok = true;
+
+    std::vector<float> X = make_clustered(n, s.dim, 1024, 0.04f, 1, 2);
+    std::vector<float> Q = make_clustered(nq, s.dim, 1024, 0.04f, 1, 3);
+    decay(X, s.dim);
+    decay(Q, s.dim);
+    std::vector<float> slices = matryoshka_slices(X.data(), n, s.dim, s.slice);
+    std::cout << "corpus " << n << " x " << s.dim << ", first pass reads " << s.slice << " of "
+              << s.dim << " dimensions" << std::endl;
+
+    // scan twin on one block against the direct top-r of the slices
+    {
+        std::vector<float> a(s.a_floats()), b(s.b_floats()), bt(s.b_floats()), out(s.out_floats());
+        tile_matrix(slices.data(), s.rows, s.slice, 4, 2, a.data());
+        std::vector<float> qs = matryoshka_slices(Q.data(), s.cols, s.dim, s.slice);
+        for (unsigned j = 0; j < s.cols; ++j)
+            for (unsigned d = 0; d < s.slice; ++d) bt[(size_t)d * s.cols + j] = qs[(size_t)j * s.slice + d];
+        tile_matrix(bt.data(), s.slice, s.cols, 2, 4, b.data());
+        twin_matryoshka_scan(s, a.data(), b.data(), 0, out.data());
+
+        std::vector<TopK> direct;
+        twin_score_topk(slices.data(), s.rows, qs.data(), s.cols, s.slice, s.topr, direct);
+        for (unsigned j = 0; j < s.cols; ++j)
+            for (unsigned p = 0; p < s.topr; ++p)
+                if ((int32_t)out[(j * s.topr + p) * 2 + 1] != direct[j].items()[p].id) ok = false;
+        if (!ok) std::cout << "scan twin DOES NOT match the slice scan" << std::endl;
+    }
+
+    std::vector<TopK> truth;
+    twin_score_topk(X.data(), n, Q.data(), nq, s.dim, k, truth);
+
+    auto recall = [&](const std::vector<TopK>& top) {
+        size_t hit = 0;
+        for (size_t q = 0; q < nq; ++q) {
+            std::unordered_set<int32_t> ids;
+            for (const ScoredId& e : truth[q].items()) ids.insert(e.id);
+            for (const ScoredId& e : top[q].items()) hit += ids.count(e.id);
+        }
+        return (double)hit / (nq * k);
+    };
+
+    const size_t pool = matryoshka_candidates(s, n);
+    std::cout << "first pass keeps " << s.topr << " of every " << s.rows << " rows: at most " << pool
+              << " candidates per query" << std::endl;
+    std::cout << "R  recall@" << k << "  QPS" << std::endl;
+    for (size_t r = 100; ; r *= 10) {
+        if (r > pool) r = pool;
+        std::vector<TopK> top;
+        auto t0 = std::chrono::steady_clock::now();
+        matryoshka_search(s, X.data(), slices.data(), n, Q.data(), nq, (unsigned)r, k, top);
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << r << "  " << recall(top) << "  "
+                  << nq / std::chrono::duration<double>(t1 - t0).count() << std::endl;
+        if (r == pool) break;
+    }
+
+    // without the per-block cap, reranking all n rows is the full scan
+    MatryoshkaShape all = s;
+    all.topr = s.rows;
+    std::vector<TopK> top;
+    matryoshka_search(all, X.data(), slices.data(), n, Q.data(), nq, (unsigned)n, k, top);
+    if (recall(top) != 1.0) {
+        std::cout << "full rerank DOES NOT match full scan" << std::endl;
+        ok = false;
+    }
+    if (ok) std::cout << "two-pass search matches full scan" << std::endl;
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,80 @@
+// PQ/ADC accuracy on synthetic clustered data: recall of the float ADC and
+// of the uint8 table the pq_adc_scan kernel uses, against the float scan.
+// Exits non-zero if the float ADC disagrees with scoring the decoded vectors.
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_set>
+
+#include "cpu_twin.h"
+#include "pq.h"
+#include "synthetic_data.h"
+
+static double recall(const TopK& got, const TopK& truth) {
+    std::unordered_set<int32_t> ids;
+    for (const ScoredId& e : truth.items()) ids.insert(e.id);
+    size_t hit = 0;
+    for (const ScoredId& e : got.items()) hit += ids.count(e.id);
+    return (double)hit / truth.items().size();
+}
+
+int main(int argc, char** argv) {
+    const size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    const size_t nq = 100;
+    const unsigned dim = 768;
+    const unsigned m = 64;
+    const unsigned k = 10;
+    const unsigned rerank = 100;    // ADC candidates kept per query
+
+    std::vector<float> X = make_clustered(n, dim, 256, 0.03f, 1, 2);
+    std::vector<float> Q = make_clustered(nq, dim, 256, 0.03f, 1, 3);
+
+    ProductQuantizer pq(dim, m);
+    pq.train(X.data(), std::min<size_t>(n, 10000), 8);
+
+    std::vector<uint8_t> codes(n * pq.code_size());
+    pq.encode(X.data(), n, codes.data());
+    std::cout << "corpus " << n << " x " << dim << ": " << dim * sizeof(float) << " B -> "
+              << pq.code_size() << " B per vector" << std::endl;
+
+    std::vector<TopK> truth;
+    twin_score_topk(X.data(), n, Q.data(), nq, dim, k, truth);
+
+    std::vector<float> lut(m * ProductQuantizer::ksub);
+    std::vector<float> decoded(dim);
+    double rFloat = 0.0, rU8 = 0.0, rFloatK = 0.0;
+    bool exact = true;
+    for (size_t q = 0; q < nq; ++q) {
+        const float* query = &Q[q * dim];
+        pq.compute_lut(query, lut.data());
+
+        TopK adcFloat(rerank), adcU8(rerank);
+        pq_adc_scan_float(lut.data(), m, codes.data(), n, adcFloat);
+        const PqQuantizedLut qlut = pq_quantize_lut(lut.data(), m);
+        pq_adc_scan_u8(qlut, m, codes.data(), n, adcU8);
+
+        // the ADC score must equal the inner product with the decoded vector
+        for (const ScoredId& e : adcFloat.items()) {
+            pq.decode(&codes[(size_t)e.id * m], 1, decoded.data());
+            if (std::fabs(twin_dot(decoded.data(), query, dim) - e.score) > 1e-3f) exact = false;
+        }
+
+        TopK topFloat(k);
+        for (unsigned i = 0; i < k && i < adcFloat.items().size(); ++i)
+            topFloat.push(adcFloat.items()[i].score, adcFloat.items()[i].id);
+        rFloatK += recall(topFloat, truth[q]);
+        rFloat += recall(adcFloat, truth[q]);
+        rU8 += recall(adcU8, truth[q]);
+    }
+
+    std::cout << "float ADC recall " << k << "@" << k << ": " << rFloatK / nq << std::endl;
+    std::cout << "float ADC recall " << k << "@" << rerank << ": " << rFloat / nq << std::endl;
+    std::cout << "uint8 ADC recall " << k << "@" << rerank << ": " << rU8 / nq << std::endl;
+
+    if (!exact) {
+        std::cout << "ADC scores DO NOT match decoded inner products" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "ADC scores match decoded inner products" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+// Recall@k / QPS trade-off of every retrieval mode on the CPU twin: float
+// scan, int8, PQ ADC (float and uint8 tables), binary prefilter + rerank
+// and IVF. Runs on synthetic clustered data, or on an ANN benchmark set:
+//
+//   recall_bench [base.{fvecs,bvecs,npy} queries.{fvecs,bvecs,npy} [gt.ivecs] [k] [max_n]]
+//
+// Scores are inner products, so a given gt.ivecs must be an inner-product
+// ground truth (the SIFT/GIST files are L2); without one it is built here
+// on all host threads. Exits non-zero if the float scan does not reproduce
+// the ground truth.
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "binary_codes.h"
+#include "cpu_twin.h"
+#include "ground_truth.h"
+#include "int8_quant.h"
+#include "ivf_index.h"
+#include "pq.h"
+#include "synthetic_data.h"
+#include "vecs_io.h"
+
+static double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void report(const std::string& mode, const std::string& param, double recall, double qps) {
+    std::cout << std::left << std::setw(8) << mode << std::setw(12) << param << std::setw(10)
+              << recall << qps << std::endl;
+}
+
+int main(int argc, char** argv) {
+    unsigned k = 10;
+    VecSet base, queries;
+    std::vector<int32_t> gt;
+    unsigned gt_k = 0;
+
+    try {
+        if (argc > 2) {
+            k = argc > 4 ? (unsigned)std::strtoul(argv[4], nullptr, 10) : 10;
+            const size_t max_n = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 0;
+            base = read_vectors(argv[1], max_n);
+            queries = read_vectors(argv[2]);
+            if (queries.dim != base.dim) throw std::runtime_error("base and query dimensions differ");
+            if (argc > 3 && std::string(argv[3]) != "-") {
+                IdSet ids = read_ivecs(argv[3], queries.n);
+                if (ids.n != queries.n || ids.dim < k)
+                    throw std::runtime_error("ground truth does not cover the queries at k");
+                gt = std::move(ids.data);
+                gt_k = ids.dim;
+            }
+        } else {
+            base.n = 50000;
+            queries.n = 200;
+            base.dim = queries.dim = 128;
+            base.data = make_clustered(base.n, base.dim, 1024, 0.08f, 1, 2);
+            queries.data = make_clustered(queries.n, queries.dim, 1024, 0.08f, 1, 3);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "recall_bench: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const size_t n = base.n, nq = queries.n;
+    const unsigned dim = base.dim;
+    const float* X = base.data.data();
+    const float* Q = queries.data.data();
+    std::cout << "corpus " << n << " x " << dim << ", " << nq << " queries, k " << k << std::endl;
+
+    if (gt.empty()) {
+        auto t0 = std::chrono::steady_clock::now();
+        gt = ground_truth_ids(build_ground_truth(X, n, Q, nq, dim, k), k);
+        gt_k = k;
+        std::cout << "ground truth built in " << seconds_since(t0) << " s" << std::endl;
+    }
+
+    std::cout << std::left << std::setw(8) << "mode" << std::setw(12) << "param" << std::setw(10)
+              << "recall@" + std::to_string(k) << "QPS" << std::endl;
+    std::vector<TopK> got;
+
+    // float: the matmult_float scan
+    auto t0 = std::chrono::steady_clock::now();
+    twin_score_topk(X, n, Q, nq, dim, k, got);
+    const double float_recall = recall_at_k(got, gt.data(), gt_k, k);
+    report("float", "-", float_recall, nq / seconds_since(t0));
+
+    // int8: per-vector symmetric quantization, int32 accumulation
+    {
+        const Int8Codes xc = int8_quantize(X, n, dim);
+        t0 = std::chrono::steady_clock::now();
+        int8_score_topk(xc, int8_quantize(Q, nq, dim), k, got);
+        report("int8", "-", recall_at_k(got, gt.data(), gt_k, k), nq / seconds_since(t0));
+    }
+
+    // PQ: ADC top-k with the float table and the kernel's uint8 table
+    for (unsigned dsub = 2; dsub <= 8; dsub *= 2) {
+        if (dim % dsub) continue;
+        const unsigned m = dim / dsub;
+        ProductQuantizer pq(dim, m);
+        pq.train(X, std::min<size_t>(n, 10000), 8);
+        std::vector<uint8_t> codes(n * pq.code_size());
+        pq.encode(X, n, codes.data());
+        std::vector<float> lut(m * ProductQuantizer::ksub);
+        std::vector<TopK> got_u8(nq, TopK(k));
+        got.assign(nq, TopK(k));
+
+        t0 = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < nq; ++q) {
+            pq.compute_lut(Q + q * dim, lut.data());
+            pq_adc_scan_float(lut.data(), m, codes.data(), n, got[q]);
+        }
+        const double qps_float = nq / seconds_since(t0);
+        t0 = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < nq; ++q) {
+            pq.compute_lut(Q + q * dim, lut.data());
+            pq_adc_scan_u8(pq_quantize_lut(lut.data(), m), m, codes.data(), n, got_u8[q]);
+        }
+        const double qps_u8 = nq / seconds_since(t0);
+        report("pq", "m=" + std::to_string(m), recall_at_k(got, gt.data(), gt_k, k), qps_float);
+        report("pq-u8", "m=" + std::to_string(m), recall_at_k(got_u8, gt.data(), gt_k, k), qps_u8);
+    }
+
+    // binary: Hamming prefilter to R candidates, float rerank
+    {
+        const unsigned words = binary_words(dim);
+        std::vector<uint32_t> codes(n * words), qcodes(nq * words);
+        binary_encode(X, n, dim, codes.data());
+        binary_encode(Q, nq, dim, qcodes.data());
+        for (size_t r = 4 * k; r <= n && r <= 4096; r *= 4) {
+            got.assign(nq, TopK(k));
+            t0 = std::chrono::steady_clock::now();
+            for (size_t q = 0; q < nq; ++q) {
+                TopK cand((unsigned)r);
+                binary_prefilter(&qcodes[q * words], codes.data(), n, words, cand);
+                binary_rerank(Q + q * dim, X, dim, cand, got[q]);
+            }
+            report("binary", "R=" + std::to_string(r), recall_at_k(got, gt.data(), gt_k, k),
+                   nq / seconds_since(t0));
+        }
+    }
+
+    // IVF: about sqrt(n) lists, nprobe sweep
+    {
+        IvfParams params;
+        params.nlist = 16;
+        while ((size_t)params.nlist * params.nlist * 4 <= n) params.nlist *= 2;
+        IvfIndex index(dim, params);
+        index.train(X, std::min<size_t>(n, (size_t)params.nlist * 64));
+        index.add(X, n);
+        for (unsigned nprobe = 1; nprobe <= params.nlist; nprobe *= 4) {
+            t0 = std::chrono::steady_clock::now();
+            index.search(Q, nq, k, nprobe, got);
+            report("ivf", std::to_string(nprobe) + "/" + std::to_string(params.nlist),
+                   recall_at_k(got, gt.data(), gt_k, k), nq / seconds_since(t0));
+        }
+    }
+
+    // the float scan is the reference up to summation order
+    if (float_recall < 0.999) {
+        std::cout << "float scan DOES NOT match ground truth" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "float scan matches ground truth" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,51 @@
+#include "attribute_filter.h"
+
+#include <algorithm>
+
+#include "cpu_twin.h"
+#include "tile_layout.h"
+
+void twin_filtered_topk(const float* X, const uint32_t* attrs, size_t n, const float* Q,
+                        const uint32_t* masks, size_t nq, unsigned dim, unsigned k,
+                        std::vector<TopK>& out, int32_t id_base) {
+    if (out.size() != nq) out.assign(nq, TopK(k));
+    for (size_t j = 0; j < nq; ++j) {
+        const float* q = Q + j * dim;
+        TopK& top = out[j];
+        for (size_t r = 0; r < n; ++r) {
+            if (!attr_match(attrs[r], masks[j])) continue;
+            top.push(twin_dot(X + r * dim, q, dim), id_base + (int32_t)r);
+        }
+    }
+}
+
+void post_filter_topk(const float* X, const uint32_t* attrs, size_t n, const float* Q,
+                      const uint32_t* masks, size_t nq, unsigned dim, unsigned k,
+                      unsigned fetch_k, std::vector<TopK>& out) {
+    std::vector<TopK> fetched;
+    twin_score_topk(X, n, Q, nq, dim, fetch_k, fetched);
+    out.assign(nq, TopK(k));
+    for (size_t j = 0; j < nq; ++j)
+        for (const ScoredId& e : fetched[j].items())
+            if (attr_match(attrs[e.id], masks[j])) out[j].push(e.score, e.id);
+}
+
+void pack_filtered_block(const float* X, const uint32_t* attrs, size_t first, size_t count,
+                         unsigned block_rows, unsigned dim, int32_t* payload) {
+    std::vector<float> rows((size_t)block_rows * dim, 0.0f), tiled(rows.size());
+    std::copy(X + first * dim, X + (first + count) * dim, rows.begin());
+    tile_matrix(rows.data(), block_rows, dim, 4, 2, tiled.data());
+    for (size_t i = 0; i < tiled.size(); ++i) payload[i] = (int32_t)tiled[i];
+    for (unsigned r = 0; r < block_rows; ++r)
+        payload[tiled.size() + r] = r < count ? (int32_t)attrs[first + r] : 0;
+}
+
+void pack_filtered_queries(const float* Q, const uint32_t* masks, unsigned nq, unsigned dim,
+                           int32_t* stream) {
+    std::vector<float> bt((size_t)dim * nq), tiled(bt.size());
+    for (unsigned j = 0; j < nq; ++j)
+        for (unsigned d = 0; d < dim; ++d) bt[(size_t)d * nq + j] = Q[(size_t)j * dim + d];
+    tile_matrix(bt.data(), dim, nq, 2, 4, tiled.data());
+    for (size_t i = 0; i < tiled.size(); ++i) stream[i] = (int32_t)tiled[i];
+    for (unsigned j = 0; j < nq; ++j) stream[tiled.size() + j] = (int32_t)masks[j];
+}
@@ -0,0 +1,44 @@
+#ifndef __ATTRIBUTE_FILTER_H__
+#define __ATTRIBUTE_FILTER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Per-vector 32-bit attribute words (tenant, document type, ... as tag
+// bits). A vector passes a query when it carries every bit of the query's
+// mask, the test aie_vadd_window and aie_core1_filtered apply before top-K
+// insertion. Bit 31 marks real vectors so block padding never passes.
+static const uint32_t ATTR_VALID = 1u << 31;
+
+inline uint32_t attr_word(uint32_t tags) { return ATTR_VALID | tags; }
+inline uint32_t query_mask(uint32_t tags) { return ATTR_VALID | tags; }
+inline bool attr_match(uint32_t attr, uint32_t mask) { return (attr & mask) == mask; }
+
+// Twin of the filtered scan: per-query top-k over the rows that pass the
+// query's mask. Same chunking contract as twin_score_topk.
+void twin_filtered_topk(const float* X, const uint32_t* attrs, size_t n, const float* Q,
+                        const uint32_t* masks, size_t nq, unsigned dim, unsigned k,
+                        std::vector<TopK>& out, int32_t id_base = 0);
+
+// Post-filter baseline: top-fetch_k unfiltered, then drop what fails the
+// mask and keep the best k
+void post_filter_topk(const float* X, const uint32_t* attrs, size_t n, const float* Q,
+                      const uint32_t* masks, size_t nq, unsigned dim, unsigned k,
+                      unsigned fetch_k, std::vector<TopK>& out);
+
+// aie_core1_filtered packet payload for rows [first, first + count) of X:
+// the block_rows x dim block in 4x2 tile order followed by block_rows
+// attribute words. Rows past count are zero with attribute 0. Values are
+// written as int32, as the packet streams carry them.
+void pack_filtered_block(const float* X, const uint32_t* attrs, size_t first, size_t count,
+                         unsigned block_rows, unsigned dim, int32_t* payload);
+
+// aie_core1_filtered query stream: dim x nq queries in 2x4 tile order
+// followed by the nq masks
+void pack_filtered_queries(const float* Q, const uint32_t* masks, unsigned nq, unsigned dim,
+                           int32_t* stream);
+
+#endif
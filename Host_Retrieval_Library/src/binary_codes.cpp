@@ -0,0 +1,31 @@
+#include "binary_codes.h"
+
+#include "cpu_twin.h"
+
+void binary_encode(const float* X, size_t n, unsigned dim, uint32_t* codes) {
+    const unsigned words = binary_words(dim);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t* code = codes + i * words;
+        for (unsigned w = 0; w < words; ++w) code[w] = 0;
+        for (unsigned d = 0; d < dim; ++d)
+            if (X[i * dim + d] > 0.0f) code[d / 32] |= 1u << (d % 32);
+    }
+}
+
+uint32_t hamming(const uint32_t* a, const uint32_t* b, unsigned words) {
+    uint32_t h = 0;
+    for (unsigned w = 0; w < words; ++w) h += __builtin_popcount(a[w] ^ b[w]);
+    return h;
+}
+
+void binary_prefilter(const uint32_t* qcode, const uint32_t* codes, size_t n, unsigned words,
+                      TopK& out, int32_t id_base) {
+    for (size_t i = 0; i < n; ++i)
+        out.push(-(float)hamming(qcode, codes + i * words, words), id_base + (int32_t)i);
+}
+
+void binary_rerank(const float* q, const float* X, unsigned dim, const TopK& candidates,
+                   TopK& out) {
+    for (const ScoredId& c : candidates.items())
+        out.push(twin_dot(q, X + (size_t)c.id * dim, dim), c.id);
+}
@@ -0,0 +1,30 @@
+#ifndef __BINARY_CODES_H__
+#define __BINARY_CODES_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Sign-bit codes: bit d of word w is set when dimension 32 * w + d is
+// positive. Same packing as the aie_hamming_prefilter streams.
+inline unsigned binary_words(unsigned dim) { return (dim + 31) / 32; }
+
+void binary_encode(const float* X, size_t n, unsigned dim, uint32_t* codes);
+
+uint32_t hamming(const uint32_t* a, const uint32_t* b, unsigned words);
+
+// Twin of aie_hamming_prefilter for one query: the out.k() nearest codes,
+// stored as score = -distance so the nearest comes first
+void binary_prefilter(const uint32_t* qcode, const uint32_t* codes, size_t n, unsigned words,
+                      TopK& out, int32_t id_base = 0);
+
+// Exact float rescoring of one query's prefilter candidates, keeping the
+// out.k() best. On device aie_rerank does the same per query, over one
+// packet of up to RR_ROWS candidate rows (BIN_TOPR from every shard), and
+// keeps RR_TOPK.
+void binary_rerank(const float* q, const float* X, unsigned dim, const TopK& candidates,
+                   TopK& out);
+
+#endif
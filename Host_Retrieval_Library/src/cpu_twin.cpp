@@ -0,0 +1,71 @@
+#include "cpu_twin.h"
+
+#include <algorithm>
+
+#include "tile_layout.h"
+
+float twin_dot(const float* a, const float* b, unsigned dim) {
+    float s = 0.0f;
+    for (unsigned i = 0; i < dim; ++i) s += a[i] * b[i];
+    return s;
+}
+
+void twin_matmult_colmax(const float* X, size_t n, const float* Q, size_t nq, unsigned dim,
+                         float* colMax, int32_t* colArg) {
+    for (size_t j = 0; j < nq; ++j) {
+        float best = -1e30f;
+        int32_t arg = -1;
+        for (size_t r = 0; r < n; ++r) {
+            const float v = twin_dot(X + r * dim, Q + j * dim, dim);
+            if (v > best) {
+                best = v;
+                arg = (int32_t)r;
+            }
+        }
+        colMax[j] = best;
+        if (colArg) colArg[j] = arg;
+    }
+}
+
+void twin_score_topk(const float* X, size_t n, const float* Q, size_t nq, unsigned dim,
+                     unsigned k, std::vector<TopK>& out, int32_t id_base) {
+    if (out.size() != nq) out.assign(nq, TopK(k));
+    for (size_t j = 0; j < nq; ++j) {
+        const float* q = Q + j * dim;
+        TopK& top = out[j];
+        for (size_t r = 0; r < n; ++r) {
+            top.push(twin_dot(X + r * dim, q, dim), id_base + (int32_t)r);
+        }
+    }
+}
+
+void twin_ivf_coarse_topk(const CoarseShape& s, const float* a, const float* b, unsigned block,
+                          float* out) {
+    std::vector<float> A(s.a_floats()), B(s.b_floats());
+    untile_matrix(a, s.rows, s.dim, 4, 2, A.data());
+    untile_matrix(b, s.dim, s.cols, 2, 4, B.data());
+
+    const unsigned P = s.nprobe;
+    std::vector<float> score(P), id(P);
+    for (unsigned j = 0; j < s.cols; ++j) {
+        std::fill(score.begin(), score.end(), -1e30f);
+        std::fill(id.begin(), id.end(), -1.0f);
+        for (unsigned r = 0; r < s.rows; ++r) {
+            float v = 0.0f;
+            for (unsigned d = 0; d < s.dim; ++d) v += A[(size_t)r * s.dim + d] * B[(size_t)d * s.cols + j];
+            if (v <= score[P - 1]) continue;
+            unsigned p = P - 1;
+            while (p > 0 && score[p - 1] < v) {
+                score[p] = score[p - 1];
+                id[p] = id[p - 1];
+                --p;
+            }
+            score[p] = v;
+            id[p] = (float)(block * s.rows + r);
+        }
+        for (unsigned p = 0; p < P; ++p) {
+            *out++ = score[p];
+            *out++ = id[p];
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef __CPU_TWIN_H__
+#define __CPU_TWIN_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// CPU twin of the AIE scoring kernels. Matrices are logical row-major:
+// X holds n corpus vectors (the A side of matmult_float) and Q holds nq
+// queries (the columns of B), all of dimension dim.
+
+// Inner product of two dim-long vectors
+float twin_dot(const float* a, const float* b, unsigned dim);
+
+// Column max/argmax of C = X x Q^T, i.e. what matmult_float reduces to
+void twin_matmult_colmax(const float* X, size_t n, const float* Q, size_t nq, unsigned dim,
+                         float* colMax, int32_t* colArg);
+
+// Per-query top-k over all n rows; ids are id_base + row. If out already
+// holds nq lists the hits are pushed into them, so a corpus can be scanned
+// chunk by chunk.
+void twin_score_topk(const float* X, size_t n, const float* Q, size_t nq, unsigned dim,
+                     unsigned k, std::vector<TopK>& out, int32_t id_base = 0);
+
+// Window shape of the ivf_coarse_topk graph (system_settings.h)
+struct CoarseShape {
+    unsigned rows = 128;      // F_Ra centroids per window
+    unsigned dim = 32;        // F_Ca
+    unsigned cols = 32;       // F_Cb queries per window
+    unsigned nprobe = 8;      // IVF_NPROBE
+    unsigned nlist = 1024;    // IVF_NLIST, centroid rows the kernel cycles through
+
+    size_t a_floats() const { return (size_t)rows * dim; }
+    size_t b_floats() const { return (size_t)dim * cols; }
+    size_t out_floats() const { return (size_t)cols * nprobe * 2; }
+};
+
+// Twin of one ivf_coarse_topk invocation on tiled a (4x2) and b (2x4)
+// windows; block is the kernel's centroid block counter
+void twin_ivf_coarse_topk(const CoarseShape& s, const float* a, const float* b, unsigned block,
+                          float* out);
+
+#endif
@@ -0,0 +1,57 @@
+#include "ground_truth.h"
+
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+
+static float dot8(const float* a, const float* b, unsigned dim) {
+    float s[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    unsigned i = 0;
+    for (; i + 8 <= dim; i += 8)
+        for (unsigned l = 0; l < 8; ++l) s[l] += a[i + l] * b[i + l];
+    float t = ((s[0] + s[1]) + (s[2] + s[3])) + ((s[4] + s[5]) + (s[6] + s[7]));
+    for (; i < dim; ++i) t += a[i] * b[i];
+    return t;
+}
+
+std::vector<TopK> build_ground_truth(const float* X, size_t n, const float* Q, size_t nq,
+                                     unsigned dim, unsigned k, unsigned threads) {
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(nq, 1));
+    std::vector<TopK> out(nq, TopK(k));
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            for (size_t q = t; q < nq; q += threads) {
+                const float* query = Q + q * dim;
+                TopK& top = out[q];
+                for (size_t r = 0; r < n; ++r) {
+                    const float v = dot8(X + r * dim, query, dim);
+                    if (v > top.threshold()) top.push(v, (int32_t)r);
+                }
+            }
+        });
+    }
+    for (std::thread& th : pool) th.join();
+    return out;
+}
+
+std::vector<int32_t> ground_truth_ids(const std::vector<TopK>& truth, unsigned k) {
+    std::vector<int32_t> ids(truth.size() * k, -1);
+    for (size_t q = 0; q < truth.size(); ++q) {
+        const std::vector<ScoredId>& items = truth[q].items();
+        for (size_t i = 0; i < items.size() && i < k; ++i) ids[q * k + i] = items[i].id;
+    }
+    return ids;
+}
+
+double recall_at_k(const std::vector<TopK>& got, const int32_t* truth, unsigned gt_k, unsigned k) {
+    if (got.empty()) return 0.0;
+    size_t hit = 0;
+    for (size_t q = 0; q < got.size(); ++q) {
+        std::unordered_set<int32_t> ids(truth + q * gt_k, truth + q * gt_k + std::min(k, gt_k));
+        const std::vector<ScoredId>& items = got[q].items();
+        for (size_t i = 0; i < items.size() && i < k; ++i) hit += ids.count(items[i].id);
+    }
+    return (double)hit / (got.size() * (size_t)k);
+}
@@ -0,0 +1,24 @@
+#ifndef __GROUND_TRUTH_H__
+#define __GROUND_TRUTH_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Exact inner-product top-k of nq queries over n corpus vectors, queries
+// split over host threads (0 = hardware concurrency). The dot products
+// keep eight partial sums so the compiler vectorizes them.
+std::vector<TopK> build_ground_truth(const float* X, size_t n, const float* Q, size_t nq,
+                                     unsigned dim, unsigned k, unsigned threads = 0);
+
+// Ground truth as nq x k ids, e.g. for write_ivecs; short lists pad with -1
+std::vector<int32_t> ground_truth_ids(const std::vector<TopK>& truth, unsigned k);
+
+// recall@k: the share of each query's true top-k found in its returned
+// top-k, averaged over queries. truth holds gt_k >= k ids per query
+// (ivecs layout); only its first k count.
+double recall_at_k(const std::vector<TopK>& got, const int32_t* truth, unsigned gt_k, unsigned k);
+
+#endif
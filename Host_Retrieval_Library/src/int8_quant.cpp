@@ -0,0 +1,38 @@
+#include "int8_quant.h"
+
+#include <cmath>
+#include <stdexcept>
+
+Int8Codes int8_quantize(const float* X, size_t n, unsigned dim) {
+    Int8Codes c;
+    c.n = n;
+    c.dim = dim;
+    c.data.resize(n * dim);
+    c.scale.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const float* x = X + i * dim;
+        float amax = 0.0f;
+        for (unsigned d = 0; d < dim; ++d) amax = std::fmax(amax, std::fabs(x[d]));
+        const float s = amax > 0.0f ? amax / 127.0f : 1.0f;
+        c.scale[i] = s;
+        for (unsigned d = 0; d < dim; ++d) c.data[i * dim + d] = (int8_t)std::lrint(x[d] / s);
+    }
+    return c;
+}
+
+int32_t int8_dot(const int8_t* a, const int8_t* b, unsigned dim) {
+    int32_t s = 0;
+    for (unsigned d = 0; d < dim; ++d) s += (int32_t)a[d] * b[d];
+    return s;
+}
+
+void int8_score_topk(const Int8Codes& X, const Int8Codes& Q, unsigned k, std::vector<TopK>& out) {
+    if (X.dim != Q.dim) throw std::invalid_argument("int8_score_topk: dimension mismatch");
+    out.assign(Q.n, TopK(k));
+    for (size_t q = 0; q < Q.n; ++q) {
+        const int8_t* query = &Q.data[q * Q.dim];
+        TopK& top = out[q];
+        for (size_t r = 0; r < X.n; ++r)
+            top.push(int8_dot(&X.data[r * X.dim], query, X.dim) * X.scale[r] * Q.scale[q], (int32_t)r);
+    }
+}
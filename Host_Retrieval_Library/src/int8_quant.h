@@ -0,0 +1,28 @@
+#ifndef __INT8_QUANT_H__
+#define __INT8_QUANT_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Symmetric int8 vectors for the int8 MMUL path (matmult_int8): every row
+// is scaled by 127 / max|x| and rounded, the scale kept so a raw int32 dot
+// maps back to the float score as raw * scale[row] * query scale.
+struct Int8Codes {
+    size_t n = 0;
+    unsigned dim = 0;
+    std::vector<int8_t> data;     // n x dim
+    std::vector<float> scale;     // per row, float = int8 * scale
+};
+
+Int8Codes int8_quantize(const float* X, size_t n, unsigned dim);
+
+int32_t int8_dot(const int8_t* a, const int8_t* b, unsigned dim);
+
+// Per-query top-k of the int8 corpus against int8 queries, int32
+// accumulation as on the AIE, scores rescaled to float
+void int8_score_topk(const Int8Codes& X, const Int8Codes& Q, unsigned k, std::vector<TopK>& out);
+
+#endif
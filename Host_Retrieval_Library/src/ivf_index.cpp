@@ -0,0 +1,109 @@
+#include "ivf_index.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "cpu_twin.h"
+#include "tile_layout.h"
+
+// MMUL block shape of the float scan kernels (A side)
+static const unsigned TILE_M = 4;
+static const unsigned TILE_K = 2;
+
+std::vector<uint64_t> IvfDeviceLayout::probe_blocks(const TopK& probes) const {
+    std::vector<uint64_t> blocks;
+    for (const ScoredId& p : probes.items()) {
+        if (p.id < 0) continue;
+        const IvfListEntry& e = lists[p.id];
+        for (uint32_t b = 0; b < e.num_blocks; ++b)
+            blocks.push_back(e.offset + b * block_floats());
+    }
+    return blocks;
+}
+
+IvfIndex::IvfIndex(unsigned dim, const IvfParams& params)
+    : dim_(dim), params_(params), list_data_(params.nlist), list_ids_(params.nlist) {
+    if (dim % TILE_K || params.block_rows % TILE_M)
+        throw std::invalid_argument("IvfIndex: dim and block_rows must match the MMUL tile");
+}
+
+void IvfIndex::train(const float* X, size_t n, KmeansAssigner& assigner) {
+    if (n < params_.nlist) throw std::invalid_argument("IvfIndex::train: fewer vectors than lists");
+    KmeansParams kp;
+    kp.k = params_.nlist;
+    kp.iters = params_.kmeans_iters;
+    kp.seed = params_.seed;
+    centroids_ = kmeans_train(X, n, dim_, kp, assigner);
+}
+
+void IvfIndex::train(const float* X, size_t n) {
+    TwinKmeansAssigner assigner;
+    train(X, n, assigner);
+}
+
+void IvfIndex::add(const float* X, size_t n) {
+    if (centroids_.empty()) throw std::logic_error("IvfIndex::add: index is not trained");
+    std::vector<TopK> assign;
+    twin_score_topk(centroids_.data(), params_.nlist, X, n, dim_, 1, assign);
+    for (size_t i = 0; i < n; ++i) {
+        const int32_t c = assign[i].items()[0].id;
+        list_data_[c].insert(list_data_[c].end(), X + i * dim_, X + (i + 1) * dim_);
+        list_ids_[c].push_back((int32_t)(ntotal_ + i));
+    }
+    ntotal_ += n;
+}
+
+void IvfIndex::probe(const float* Q, size_t nq, unsigned nprobe, std::vector<TopK>& out) const {
+    out.clear();
+    twin_score_topk(centroids_.data(), params_.nlist, Q, nq, dim_, nprobe, out);
+}
+
+void IvfIndex::search(const float* Q, size_t nq, unsigned k, unsigned nprobe,
+                      std::vector<TopK>& out) const {
+    std::vector<TopK> probes;
+    probe(Q, nq, nprobe, probes);
+
+    out.assign(nq, TopK(k));
+    for (size_t j = 0; j < nq; ++j) {
+        const float* q = Q + j * dim_;
+        for (const ScoredId& p : probes[j].items()) {
+            const std::vector<float>& data = list_data_[p.id];
+            const std::vector<int32_t>& ids = list_ids_[p.id];
+            for (size_t r = 0; r < ids.size(); ++r)
+                out[j].push(twin_dot(&data[r * dim_], q, dim_), ids[r]);
+        }
+    }
+}
+
+IvfDeviceLayout IvfIndex::device_layout() const {
+    IvfDeviceLayout layout;
+    layout.dim = dim_;
+    layout.block_rows = params_.block_rows;
+
+    const unsigned rows = params_.block_rows;
+    std::vector<float> block((size_t)rows * dim_);
+    for (unsigned c = 0; c < params_.nlist; ++c) {
+        const size_t nvec = list_ids_[c].size();
+        IvfListEntry e;
+        e.offset = layout.data.size();
+        e.num_blocks = (uint32_t)((nvec + rows - 1) / rows);
+        e.num_vectors = (uint32_t)nvec;
+        layout.lists.push_back(e);
+
+        for (uint32_t b = 0; b < e.num_blocks; ++b) {
+            const size_t first = (size_t)b * rows;
+            const size_t valid = std::min<size_t>(rows, nvec - first);
+            std::fill(block.begin(), block.end(), 0.0f);
+            const float* src = list_data_[c].data() + first * dim_;
+            std::copy(src, src + valid * dim_, block.begin());
+
+            const size_t at = layout.data.size();
+            layout.data.resize(at + block.size());
+            tile_matrix(block.data(), rows, dim_, TILE_M, TILE_K, &layout.data[at]);
+
+            for (size_t r = 0; r < rows; ++r)
+                layout.ids.push_back(r < valid ? list_ids_[c][first + r] : -1);
+        }
+    }
+    return layout;
+}
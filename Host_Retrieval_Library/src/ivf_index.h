@@ -0,0 +1,78 @@
+#ifndef __IVF_INDEX_H__
+#define __IVF_INDEX_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "kmeans.h"
+#include "topk.h"
+
+struct IvfParams {
+    unsigned nlist = 1024;        // number of coarse centroids (IVF_NLIST)
+    unsigned kmeans_iters = 10;
+    unsigned block_rows = 128;    // scan tile block height (F_Ra)
+    uint32_t seed = 12262023;
+};
+
+// One posting list inside IvfDeviceLayout::data
+struct IvfListEntry {
+    uint64_t offset;        // first float of the list in data
+    uint32_t num_blocks;    // block_rows-row blocks, padding included
+    uint32_t num_vectors;   // real vectors
+};
+
+// Posting lists as they sit in device memory: every list is padded to whole
+// block_rows-row blocks and stored back to back, each block in the 4x2 MMUL
+// tile order the scan kernels load (see write_file.py::mat2file_tile).
+// Padding rows are zero vectors with id -1 and must be dropped on merge.
+struct IvfDeviceLayout {
+    unsigned dim = 0;
+    unsigned block_rows = 0;
+    std::vector<IvfListEntry> lists;
+    std::vector<float> data;
+    std::vector<int32_t> ids;     // global id per stored row
+
+    size_t block_floats() const { return (size_t)block_rows * dim; }
+
+    // Block offsets (in floats) to stream to the scan tiles for one query
+    std::vector<uint64_t> probe_blocks(const TopK& probes) const;
+};
+
+// Inverted-file index over inner-product (spherical k-means) centroids.
+// The coarse pass is the same column argmax as matmult_float, so it runs on
+// the ivf_coarse_topk graph or on the CPU twin.
+class IvfIndex {
+public:
+    IvfIndex(unsigned dim, const IvfParams& params);
+
+    unsigned dim() const { return dim_; }
+    unsigned nlist() const { return params_.nlist; }
+    size_t size() const { return ntotal_; }
+    const std::vector<float>& centroids() const { return centroids_; }
+
+    // Learns the centroids from n training vectors; the assignment step runs
+    // on the given backend, or on the threaded CPU twin
+    void train(const float* X, size_t n, KmeansAssigner& assigner);
+    void train(const float* X, size_t n);
+    // Appends n vectors; ids continue from size()
+    void add(const float* X, size_t n);
+
+    // Coarse pass: the nprobe best centroids per query
+    void probe(const float* Q, size_t nq, unsigned nprobe, std::vector<TopK>& out) const;
+    // Two-stage search: probe, then scan the selected posting lists
+    void search(const float* Q, size_t nq, unsigned k, unsigned nprobe,
+                std::vector<TopK>& out) const;
+
+    IvfDeviceLayout device_layout() const;
+
+private:
+    unsigned dim_;
+    IvfParams params_;
+    size_t ntotal_ = 0;
+    std::vector<float> centroids_;                 // nlist x dim
+    std::vector<std::vector<float>> list_data_;    // per list, row-major
+    std::vector<std::vector<int32_t>> list_ids_;
+};
+
+#endif
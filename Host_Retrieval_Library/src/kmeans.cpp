@@ -0,0 +1,181 @@
+#include "kmeans.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "tile_layout.h"
+
+static unsigned resolve_threads(unsigned threads) {
+    if (threads) return threads;
+    const unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+// Runs fn(thread, begin, end) over [0, n), one contiguous range per thread
+template <typename Fn>
+static void parallel_ranges(size_t n, unsigned threads, Fn fn) {
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(n, 1));
+    std::vector<std::thread> pool;
+    const size_t chunk = (n + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        const size_t b = t * chunk, e = std::min(n, b + chunk);
+        if (b >= e) break;
+        pool.emplace_back(fn, t, b, e);
+    }
+    for (std::thread& th : pool) th.join();
+}
+
+TwinKmeansAssigner::TwinKmeansAssigner(unsigned threads) : threads_(resolve_threads(threads)) {}
+
+void TwinKmeansAssigner::assign(const float* C, unsigned k, const float* X, size_t n, unsigned dim,
+                                int32_t* idx, float* score) {
+    parallel_ranges(n, threads_, [&](unsigned, size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) {
+            const float* x = X + i * dim;
+            float best = -1e30f;
+            int32_t arg = -1;
+            for (unsigned c = 0; c < k; ++c) {
+                const float v = twin_dot(C + (size_t)c * dim, x, dim);
+                if (v > best) {
+                    best = v;
+                    arg = (int32_t)c;
+                }
+            }
+            idx[i] = arg;
+            score[i] = best;
+        }
+    });
+}
+
+AieKmeansAssigner::AieKmeansAssigner(const CoarseShape& shape, CoarseRunner run)
+    : shape_(shape), run_(run) {
+    if (shape.nlist % shape.rows)
+        throw std::invalid_argument("AieKmeansAssigner: nlist must be whole centroid blocks");
+}
+
+void AieKmeansAssigner::assign(const float* C, unsigned k, const float* X, size_t n, unsigned dim,
+                               int32_t* idx, float* score) {
+    const CoarseShape& s = shape_;
+    if (dim != s.dim || k > s.nlist)
+        throw std::invalid_argument("AieKmeansAssigner: problem does not fit the coarse graph");
+
+    // centroid windows are fixed for the whole pass
+    const unsigned nblocks = s.nlist / s.rows;
+    std::vector<float> cen((size_t)s.nlist * dim);
+    for (unsigned c = 0; c < s.nlist; ++c) {
+        const float* src = C + (size_t)(c < k ? c : 0) * dim;
+        std::copy(src, src + dim, &cen[(size_t)c * dim]);
+    }
+    std::vector<float> a((size_t)nblocks * s.a_floats());
+    for (unsigned blk = 0; blk < nblocks; ++blk)
+        tile_matrix(&cen[(size_t)blk * s.rows * dim], s.rows, dim, 4, 2, &a[blk * s.a_floats()]);
+
+    std::vector<float> bt(s.b_floats()), b(s.b_floats()), out(s.out_floats());
+    for (size_t first = 0; first < n; first += s.cols) {
+        // one window of s.cols vectors as columns; the tail is zero padded
+        const size_t cnt = std::min<size_t>(s.cols, n - first);
+        std::fill(bt.begin(), bt.end(), 0.0f);
+        for (size_t j = 0; j < cnt; ++j)
+            for (unsigned d = 0; d < dim; ++d) bt[(size_t)d * s.cols + j] = X[(first + j) * dim + d];
+        tile_matrix(bt.data(), dim, s.cols, 2, 4, b.data());
+
+        for (size_t j = 0; j < cnt; ++j) {
+            idx[first + j] = -1;
+            score[first + j] = -1e30f;
+        }
+        for (unsigned blk = 0; blk < nblocks; ++blk) {
+            run_(&a[blk * s.a_floats()], b.data(), blk, out.data());
+            ++invocations_;
+            // the first of each column's nprobe pairs is the block argmax
+            for (size_t j = 0; j < cnt; ++j) {
+                const float v = out[j * s.nprobe * 2];
+                if (v > score[first + j]) {
+                    score[first + j] = v;
+                    const int32_t c = (int32_t)out[j * s.nprobe * 2 + 1];
+                    idx[first + j] = c < (int32_t)k ? c : 0;
+                }
+            }
+        }
+    }
+}
+
+std::vector<float> kmeans_train(const float* X, size_t n, unsigned dim, const KmeansParams& params,
+                                KmeansAssigner& assigner, KmeansStats* stats) {
+    const unsigned k = params.k;
+    if (n < k) throw std::invalid_argument("kmeans_train: fewer vectors than centroids");
+    const unsigned threads = resolve_threads(params.threads);
+
+    std::mt19937 rng(params.seed);
+    std::vector<size_t> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), rng);
+
+    std::vector<float> C((size_t)k * dim);
+    for (unsigned c = 0; c < k; ++c)
+        std::copy(X + perm[c] * dim, X + (perm[c] + 1) * dim, &C[(size_t)c * dim]);
+
+    std::vector<int32_t> idx(n);
+    std::vector<float> score(n);
+    // per-thread partial sums, reduced after every pass
+    std::vector<std::vector<double>> sums(threads, std::vector<double>((size_t)k * dim));
+    std::vector<std::vector<size_t>> counts(threads, std::vector<size_t>(k));
+
+    for (unsigned it = 0; it < params.iters; ++it) {
+        auto t0 = std::chrono::steady_clock::now();
+        assigner.assign(C.data(), k, X, n, dim, idx.data(), score.data());
+        auto t1 = std::chrono::steady_clock::now();
+
+        parallel_ranges(n, threads, [&](unsigned t, size_t b, size_t e) {
+            std::vector<double>& s = sums[t];
+            std::vector<size_t>& cnt = counts[t];
+            std::fill(s.begin(), s.end(), 0.0);
+            std::fill(cnt.begin(), cnt.end(), 0);
+            for (size_t i = b; i < e; ++i) {
+                double* acc = &s[(size_t)idx[i] * dim];
+                for (unsigned d = 0; d < dim; ++d) acc[d] += X[i * dim + d];
+                ++cnt[idx[i]];
+            }
+        });
+
+        parallel_ranges(k, threads, [&](unsigned, size_t b, size_t e) {
+            for (size_t c = b; c < e; ++c) {
+                size_t total = 0;
+                for (unsigned t = 0; t < threads; ++t) total += counts[t][c];
+                float* cen = &C[c * dim];
+                if (total == 0) continue;
+                double norm = 0.0;
+                for (unsigned d = 0; d < dim; ++d) {
+                    double v = 0.0;
+                    for (unsigned t = 0; t < threads; ++t) v += sums[t][c * dim + d];
+                    cen[d] = (float)v;
+                    norm += v * v;
+                }
+                norm = std::sqrt(norm);
+                if (norm > 0.0)
+                    for (unsigned d = 0; d < dim; ++d) cen[d] = (float)(cen[d] / norm);
+            }
+        });
+
+        // empty clusters restart from a random vector (serial: shares rng)
+        for (unsigned c = 0; c < k; ++c) {
+            size_t total = 0;
+            for (unsigned t = 0; t < threads; ++t) total += counts[t][c];
+            if (total) continue;
+            const size_t r = rng() % n;
+            std::copy(X + r * dim, X + (r + 1) * dim, &C[(size_t)c * dim]);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        if (stats) {
+            stats->assign_seconds += std::chrono::duration<double>(t1 - t0).count();
+            stats->update_seconds += std::chrono::duration<double>(t2 - t1).count();
+            stats->objective.push_back(std::accumulate(score.begin(), score.end(), 0.0) / n);
+        }
+    }
+    return C;
+}
@@ -0,0 +1,73 @@
+#ifndef __KMEANS_H__
+#define __KMEANS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "cpu_twin.h"
+
+// Assignment step of spherical k-means: for each of n vectors the centroid
+// with the largest dot product, i.e. the column argmax matmult_float and
+// ivf_coarse_topk compute with centroids as A and vectors as B columns.
+class KmeansAssigner {
+public:
+    virtual ~KmeansAssigner() {}
+    virtual void assign(const float* C, unsigned k, const float* X, size_t n, unsigned dim,
+                        int32_t* idx, float* score) = 0;
+};
+
+// CPU twin, rows split over host threads
+class TwinKmeansAssigner : public KmeansAssigner {
+public:
+    explicit TwinKmeansAssigner(unsigned threads = 0);
+    void assign(const float* C, unsigned k, const float* X, size_t n, unsigned dim,
+                int32_t* idx, float* score) override;
+
+private:
+    unsigned threads_;
+};
+
+// Batches the assignment through the ivf_coarse_topk graph. run executes one
+// kernel invocation (tiled centroid window a, tiled vector window b, output
+// window out) on whatever transport is available: XRT, x86sim, or
+// twin_ivf_coarse_topk. Every batch walks all shape.nlist / shape.rows
+// centroid blocks in order, as the kernel's block counter expects; k may be
+// smaller than nlist, the spare rows are copies of centroid 0.
+typedef std::function<void(const float* a, const float* b, unsigned block, float* out)> CoarseRunner;
+
+class AieKmeansAssigner : public KmeansAssigner {
+public:
+    AieKmeansAssigner(const CoarseShape& shape, CoarseRunner run);
+    void assign(const float* C, unsigned k, const float* X, size_t n, unsigned dim,
+                int32_t* idx, float* score) override;
+
+    // kernel invocations issued so far
+    size_t invocations() const { return invocations_; }
+
+private:
+    CoarseShape shape_;
+    CoarseRunner run_;
+    size_t invocations_ = 0;
+};
+
+struct KmeansParams {
+    unsigned k = 1024;
+    unsigned iters = 10;
+    unsigned threads = 0;         // update step threads, 0 = hardware concurrency
+    uint32_t seed = 12262023;
+};
+
+struct KmeansStats {
+    std::vector<double> objective;    // mean max dot product per iteration
+    double assign_seconds = 0.0;
+    double update_seconds = 0.0;
+};
+
+// Lloyd iterations of spherical k-means on n unit vectors; returns k x dim
+// unit centroids. Empty clusters restart from a random training vector.
+std::vector<float> kmeans_train(const float* X, size_t n, unsigned dim, const KmeansParams& params,
+                                KmeansAssigner& assigner, KmeansStats* stats = nullptr);
+
+#endif
@@ -0,0 +1,68 @@
+#include "matryoshka.h"
+
+#include <algorithm>
+
+#include "cpu_twin.h"
+#include "tile_layout.h"
+
+std::vector<float> matryoshka_slices(const float* X, size_t n, unsigned dim, unsigned slice) {
+    std::vector<float> out(n * slice);
+    for (size_t i = 0; i < n; ++i)
+        std::copy(X + i * dim, X + i * dim + slice, &out[i * slice]);
+    return out;
+}
+
+void twin_matryoshka_scan(const MatryoshkaShape& s, const float* a, const float* b, unsigned block,
+                          float* out) {
+    std::vector<float> A(s.a_floats()), B(s.b_floats());
+    untile_matrix(a, s.rows, s.slice, 4, 2, A.data());
+    untile_matrix(b, s.slice, s.cols, 2, 4, B.data());
+
+    for (unsigned j = 0; j < s.cols; ++j) {
+        TopK top(s.topr);
+        for (unsigned r = 0; r < s.rows; ++r) {
+            float v = 0.0f;
+            for (unsigned d = 0; d < s.slice; ++d) v += A[(size_t)r * s.slice + d] * B[(size_t)d * s.cols + j];
+            top.push(v, (int32_t)(block * s.rows + r));
+        }
+        float* o = out + (size_t)j * s.topr * 2;
+        for (unsigned p = 0; p < s.topr; ++p) {
+            const bool used = p < top.items().size();
+            o[2 * p] = used ? top.items()[p].score : -1e30f;
+            o[2 * p + 1] = used ? (float)top.items()[p].id : -1.0f;
+        }
+    }
+}
+
+float rerank_dot(const float* a, const float* b, unsigned dim) {
+    float acc[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    unsigned i = 0;
+    for (; i + 8 <= dim; i += 8)
+        for (unsigned l = 0; l < 8; ++l) acc[l] += a[i + l] * b[i + l];
+    float s = ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+    for (; i < dim; ++i) s += a[i] * b[i];
+    return s;
+}
+
+size_t matryoshka_candidates(const MatryoshkaShape& s, size_t n) {
+    const size_t full = n / s.rows, tail = n % s.rows;
+    return full * std::min(s.topr, s.rows) + std::min<size_t>(s.topr, tail);
+}
+
+void matryoshka_search(const MatryoshkaShape& s, const float* X, const float* slices, size_t n,
+                       const float* Q, size_t nq, unsigned r, unsigned k, std::vector<TopK>& out) {
+    std::vector<float> qs = matryoshka_slices(Q, nq, s.dim, s.slice);
+    std::vector<TopK> cand(nq, TopK(r)), block;
+    for (size_t base = 0; base < n; base += s.rows) {
+        const size_t rows = std::min<size_t>(s.rows, n - base);
+        block.assign(nq, TopK(s.topr));
+        twin_score_topk(slices + base * s.slice, rows, qs.data(), nq, s.slice, s.topr, block,
+                        (int32_t)base);
+        for (size_t j = 0; j < nq; ++j) cand[j].merge(block[j]);
+    }
+
+    out.assign(nq, TopK(k));
+    for (size_t j = 0; j < nq; ++j)
+        for (const ScoredId& e : cand[j].items())
+            out[j].push(rerank_dot(X + (size_t)e.id * s.dim, Q + j * s.dim, s.dim), e.id);
+}
@@ -0,0 +1,47 @@
+#ifndef __MATRYOSHKA_H__
+#define __MATRYOSHKA_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Window shape of the matryoshka_scan graph (system_settings.h)
+struct MatryoshkaShape {
+    unsigned slice = 64;      // MRL_DIM leading dimensions scanned on the tile
+    unsigned dim = 768;       // MRL_FULL_DIM
+    unsigned rows = 64;       // MRL_ROWS corpus rows per window
+    unsigned cols = 32;       // F_Cb queries per window
+    unsigned topr = 16;       // MRL_TOPR candidates per query and block
+
+    size_t a_floats() const { return (size_t)rows * slice; }
+    size_t b_floats() const { return (size_t)slice * cols; }
+    size_t out_floats() const { return (size_t)cols * topr * 2; }
+};
+
+// Leading slice of every row of the row-major n x dim corpus, stored as its
+// own contiguous n x slice array so the first pass streams only that
+std::vector<float> matryoshka_slices(const float* X, size_t n, unsigned dim, unsigned slice);
+
+// Twin of one matryoshka_scan invocation on a 4x2-tiled slice window a and
+// a 2x4-tiled query window b; block is the kernel's block counter
+void twin_matryoshka_scan(const MatryoshkaShape& s, const float* a, const float* b, unsigned block,
+                          float* out);
+
+// Full-dimension rescoring dot product, eight independent partial sums so
+// the compiler vectorizes it without reassociation flags
+float rerank_dot(const float* a, const float* b, unsigned dim);
+
+// First-pass candidates per query over an n-row corpus: the scan keeps
+// s.topr rows of every s.rows-row block, so the top-r is capped at this
+size_t matryoshka_candidates(const MatryoshkaShape& s, size_t n);
+
+// Two-pass search as the device runs it: the s.topr best rows per query of
+// every s.rows-row block on the s.slice-wide slices, the top-r of those
+// merged, then the k best rescored at s.dim dimensions. slices comes from
+// matryoshka_slices.
+void matryoshka_search(const MatryoshkaShape& s, const float* X, const float* slices, size_t n,
+                       const float* Q, size_t nq, unsigned r, unsigned k, std::vector<TopK>& out);
+
+#endif
@@ -0,0 +1,66 @@
+#include "maxsim.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "cpu_twin.h"
+#include "tile_layout.h"
+
+void MultiVectorCorpus::add(const float* T, size_t ntok) {
+    tokens.insert(tokens.end(), T, T + ntok * dim);
+    offsets.push_back(offsets.back() + ntok);
+}
+
+float maxsim_score(const float* D, size_t ntok, const float* Q, size_t nqt, unsigned dim) {
+    float sum = 0.0f;
+    for (size_t j = 0; j < nqt; ++j) {
+        float best = -1e30f;
+        for (size_t t = 0; t < ntok; ++t) best = std::max(best, twin_dot(D + t * dim, Q + j * dim, dim));
+        sum += best;
+    }
+    return sum;
+}
+
+void maxsim_search(const MultiVectorCorpus& corpus, const float* Q, size_t nqt, TopK& out) {
+    for (size_t d = 0; d < corpus.size(); ++d)
+        out.push(maxsim_score(corpus.doc(d), corpus.num_tokens(d), Q, nqt, corpus.dim), (int32_t)d);
+}
+
+void maxsim_pack_documents(const MaxSimShape& s, const MultiVectorCorpus& corpus, size_t first,
+                           size_t count, float* dst) {
+    if (corpus.dim != s.dim) throw std::invalid_argument("maxsim_pack_documents: dim mismatch");
+    std::vector<float> rows(s.a_floats());
+    for (size_t d = first; d < first + count; ++d) {
+        const size_t ntok = corpus.num_tokens(d);
+        if (ntok == 0 || ntok > s.rows)
+            throw std::invalid_argument("maxsim_pack_documents: document does not fit a window");
+        const float* T = corpus.doc(d);
+        std::copy(T, T + ntok * s.dim, rows.begin());
+        for (size_t t = ntok; t < s.rows; ++t) std::copy(T, T + s.dim, &rows[t * s.dim]);
+        tile_matrix(rows.data(), s.rows, s.dim, 4, 2, dst);
+        dst += s.a_floats();
+    }
+}
+
+void maxsim_pack_query(const MaxSimShape& s, const float* Q, size_t nqt, float* dst) {
+    if (nqt > s.cols) throw std::invalid_argument("maxsim_pack_query: too many query tokens");
+    std::vector<float> bt(s.b_floats(), 0.0f);
+    for (size_t j = 0; j < nqt; ++j)
+        for (unsigned d = 0; d < s.dim; ++d) bt[(size_t)d * s.cols + j] = Q[j * s.dim + d];
+    tile_matrix(bt.data(), s.dim, s.cols, 2, 4, dst);
+}
+
+void twin_maxsim_float(const MaxSimShape& s, const float* a, const float* b, TopK& out,
+                       int32_t id_base) {
+    std::vector<float> A(s.a_floats()), B(s.b_floats()), Q(s.b_floats());
+    untile_matrix(b, s.dim, s.cols, 2, 4, B.data());
+    for (unsigned j = 0; j < s.cols; ++j)
+        for (unsigned d = 0; d < s.dim; ++d) Q[(size_t)j * s.dim + d] = B[(size_t)d * s.cols + j];
+
+    TopK top(s.topk);
+    for (unsigned d = 0; d < s.docs; ++d) {
+        untile_matrix(a + d * s.a_floats(), s.rows, s.dim, 4, 2, A.data());
+        top.push(maxsim_score(A.data(), s.rows, Q.data(), s.cols, s.dim), (int32_t)d);
+    }
+    for (const ScoredId& e : top.items()) out.push(e.score, id_base + e.id);
+}
@@ -0,0 +1,58 @@
+#ifndef __MAXSIM_H__
+#define __MAXSIM_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Late-interaction (ColBERT style) corpus: every document is a variable
+// number of dim-long token embeddings, stored back to back. Document d owns
+// tokens [offsets[d], offsets[d + 1]).
+struct MultiVectorCorpus {
+    unsigned dim = 0;
+    std::vector<float> tokens;
+    std::vector<size_t> offsets{0};
+
+    size_t size() const { return offsets.size() - 1; }
+    size_t num_tokens(size_t d) const { return offsets[d + 1] - offsets[d]; }
+    const float* doc(size_t d) const { return tokens.data() + offsets[d] * dim; }
+
+    void add(const float* T, size_t ntok);
+};
+
+// Window shape of the maxsim_float graph (system_settings.h)
+struct MaxSimShape {
+    unsigned rows = 128;      // F_Ra token slots per document
+    unsigned dim = 32;        // F_Ca
+    unsigned cols = 32;       // F_Cb query tokens
+    unsigned docs = 64;       // MAXSIM_DOCS per query pass
+    unsigned topk = 8;        // MAXSIM_TOPK
+
+    size_t a_floats() const { return (size_t)rows * dim; }
+    size_t b_floats() const { return (size_t)dim * cols; }
+};
+
+// Sum over query tokens of the best dot product with any document token
+float maxsim_score(const float* D, size_t ntok, const float* Q, size_t nqt, unsigned dim);
+
+// Exhaustive MaxSim search; ids are document indices
+void maxsim_search(const MultiVectorCorpus& corpus, const float* Q, size_t nqt, TopK& out);
+
+// Documents [first, first + count) as consecutive 4x2-tiled A windows. Short
+// documents repeat their first token, which leaves every maximum unchanged;
+// longer ones throw.
+void maxsim_pack_documents(const MaxSimShape& s, const MultiVectorCorpus& corpus, size_t first,
+                           size_t count, float* dst);
+
+// Query tokens as the 2x4-tiled B window, one token per column. Missing
+// columns are zero tokens, which add exactly 0 to every document score.
+void maxsim_pack_query(const MaxSimShape& s, const float* Q, size_t nqt, float* dst);
+
+// Twin of one maxsim_float query pass over s.docs packed documents; out
+// receives the kernel's (score, doc) pairs with ids offset by id_base
+void twin_maxsim_float(const MaxSimShape& s, const float* a, const float* b, TopK& out,
+                       int32_t id_base = 0);
+
+#endif
@@ -0,0 +1,66 @@
+#include "norm_prune.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "cpu_twin.h"
+
+NormSortedCorpus norm_sort_corpus(const float* X, size_t n, unsigned dim, unsigned block_rows,
+                                  bool reorder) {
+    NormSortedCorpus c;
+    c.dim = dim;
+    c.block_rows = block_rows;
+
+    std::vector<float> norm(n);
+    for (size_t i = 0; i < n; ++i) norm[i] = std::sqrt(twin_dot(X + i * dim, X + i * dim, dim));
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if (reorder)
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return norm[a] > norm[b]; });
+
+    const size_t nblocks = (n + block_rows - 1) / block_rows;
+    c.data.assign(nblocks * block_rows * dim, 0.0f);
+    c.ids.assign(nblocks * block_rows, -1);
+    c.block_max_norm.assign(nblocks, 0.0f);
+    for (size_t r = 0; r < n; ++r) {
+        const size_t src = order[r];
+        std::copy(X + src * dim, X + (src + 1) * dim, &c.data[r * dim]);
+        c.ids[r] = (int32_t)src;
+        float& m = c.block_max_norm[r / block_rows];
+        m = std::max(m, norm[src]);
+    }
+    return c;
+}
+
+size_t twin_pruned_topk(const NormSortedCorpus& c, const float* Q, size_t nq, unsigned k,
+                        unsigned group, std::vector<TopK>& out) {
+    const unsigned dim = c.dim;
+    out.assign(nq, TopK(k));
+    std::vector<float> qnorm2(nq);
+    for (size_t j = 0; j < nq; ++j) qnorm2[j] = twin_dot(Q + j * dim, Q + j * dim, dim);
+
+    size_t skipped = 0;
+    for (size_t blk = 0; blk < c.blocks(); ++blk) {
+        const float m2 = c.block_max_norm[blk] * c.block_max_norm[blk];
+        for (size_t g = 0; g < nq; g += group) {
+            const size_t end = std::min(nq, g + group);
+            bool live = false;
+            for (size_t j = g; j < end; ++j) {
+                const float kth = out[j].full() ? out[j].threshold() : -1e30f;
+                if (kth < 0.0f || qnorm2[j] * m2 > kth * kth) live = true;
+            }
+            if (!live) {
+                ++skipped;
+                continue;
+            }
+            for (size_t j = g; j < end; ++j)
+                for (size_t r = blk * c.block_rows; r < (blk + 1) * c.block_rows; ++r) {
+                    if (c.ids[r] < 0) continue;
+                    out[j].push(twin_dot(&c.data[r * dim], Q + j * dim, dim), c.ids[r]);
+                }
+        }
+    }
+    return skipped;
+}
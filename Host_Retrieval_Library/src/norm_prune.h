@@ -0,0 +1,33 @@
+#ifndef __NORM_PRUNE_H__
+#define __NORM_PRUNE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Corpus as matmult_pruned_topk scans it: rows sorted by descending norm
+// (optional), cut into block_rows-row blocks, each annotated with its
+// largest row norm. The last block is padded with zero rows of id -1.
+struct NormSortedCorpus {
+    unsigned dim = 0;
+    unsigned block_rows = 0;
+    std::vector<float> data;              // row-major, blocks() * block_rows rows
+    std::vector<int32_t> ids;             // original row id per stored row
+    std::vector<float> block_max_norm;    // one per block, the blockNorm stream
+
+    size_t blocks() const { return block_max_norm.size(); }
+};
+
+NormSortedCorpus norm_sort_corpus(const float* X, size_t n, unsigned dim, unsigned block_rows,
+                                  bool reorder = true);
+
+// Twin of a matmult_pruned_topk scan: per-query top-k over the corpus,
+// skipping a block for a group of `group` query columns when no column's
+// bound |q| * max|x| beats its current k-th score. Ids are original row ids.
+// Returns the number of skipped (block, column group) pairs.
+size_t twin_pruned_topk(const NormSortedCorpus& c, const float* Q, size_t nq, unsigned k,
+                        unsigned group, std::vector<TopK>& out);
+
+#endif
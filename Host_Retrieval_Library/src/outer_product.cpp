@@ -0,0 +1,42 @@
+#include "outer_product.h"
+
+#include <vector>
+
+void outer_pack_queries(const OuterShape& s, const float* Q, float* q) {
+    for (unsigned k = 0; k < s.dim; ++k)
+        for (unsigned r = 0; r < s.queries; ++r) *q++ = Q[(size_t)r * s.dim + k];
+}
+
+void outer_pack_vectors(const OuterShape& s, const float* X, float* v) {
+    for (unsigned k = 0; k < s.dim; ++k)
+        for (unsigned j = 0; j < s.cols; ++j) *v++ = X[(size_t)j * s.dim + k];
+}
+
+void twin_outer_product(const OuterShape& s, const float* q, const float* v,
+                        float* rowMax, int32_t* rowArg) {
+    std::vector<float> C((size_t)s.queries * s.cols, 0.0f);
+    for (unsigned k0 = 0; k0 < s.dim; k0 += s.kblock) {
+        // one k-block: rank-kblock update of C, as the kernel's mmul mac
+        const float* qb = q + (size_t)k0 * s.queries;
+        const float* vb = v + (size_t)k0 * s.cols;
+        for (unsigned r = 0; r < s.queries; ++r)
+            for (unsigned j = 0; j < s.cols; ++j) {
+                float acc = C[(size_t)r * s.cols + j];
+                for (unsigned kk = 0; kk < s.kblock; ++kk)
+                    acc += qb[(size_t)kk * s.queries + r] * vb[(size_t)kk * s.cols + j];
+                C[(size_t)r * s.cols + j] = acc;
+            }
+    }
+    for (unsigned r = 0; r < s.queries; ++r) {
+        float best = -1e30f;
+        int32_t arg = -1;
+        for (unsigned j = 0; j < s.cols; ++j) {
+            if (C[(size_t)r * s.cols + j] > best) {
+                best = C[(size_t)r * s.cols + j];
+                arg = (int32_t)j;
+            }
+        }
+        rowMax[r] = best;
+        rowArg[r] = arg;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef __OUTER_PRODUCT_H__
+#define __OUTER_PRODUCT_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// Shape of aie_core1_outer (system_settings.h OP_*): queries against cols
+// corpus vectors per packet, dim dimensions streamed kblock at a time
+struct OuterShape {
+    unsigned queries = 32;    // OP_Ra
+    unsigned cols = 32;       // OP_Cb
+    unsigned kblock = 8;      // OP_KB
+    unsigned dim = 256;       // OP_DIM
+
+    size_t query_words() const { return (size_t)queries * dim; }
+    size_t packet_words() const { return (size_t)dim * cols; }
+    // floats the kernel keeps on the tile: C plus one k-block of A and B
+    size_t tile_floats() const { return (size_t)queries * cols + (size_t)kblock * (queries + cols); }
+};
+
+// Tile floats of the inner-product form (aie_core1) holding rows corpus
+// vectors and the query batch in full
+inline size_t inner_tile_floats(unsigned rows, unsigned queries, unsigned dim) {
+    return (size_t)rows * dim + (size_t)dim * queries;
+}
+
+// Row-major queries x dim -> broadcast stream order: for every k the
+// dimension-k value of each query
+void outer_pack_queries(const OuterShape& s, const float* Q, float* q);
+
+// Row-major cols x dim corpus vectors -> packet payload order: for every k
+// the dimension-k value of each vector
+void outer_pack_vectors(const OuterShape& s, const float* X, float* v);
+
+// Twin of one aie_core1_outer packet: C accumulated k-block by k-block,
+// then per query the best score over the packet's vectors and its column
+void twin_outer_product(const OuterShape& s, const float* q, const float* v,
+                        float* rowMax, int32_t* rowArg);
+
+#endif
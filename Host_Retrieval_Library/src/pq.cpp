@@ -0,0 +1,147 @@
+#include "pq.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "cpu_twin.h"
+
+static float l2_sqr(const float* a, const float* b, unsigned dim) {
+    float s = 0.0f;
+    for (unsigned i = 0; i < dim; ++i) {
+        const float d = a[i] - b[i];
+        s += d * d;
+    }
+    return s;
+}
+
+static unsigned nearest(const float* x, const float* book, unsigned dsub) {
+    unsigned best = 0;
+    float bestDist = l2_sqr(x, book, dsub);
+    for (unsigned c = 1; c < ProductQuantizer::ksub; ++c) {
+        const float d = l2_sqr(x, book + (size_t)c * dsub, dsub);
+        if (d < bestDist) {
+            bestDist = d;
+            best = c;
+        }
+    }
+    return best;
+}
+
+ProductQuantizer::ProductQuantizer(unsigned dim, unsigned m)
+    : dim_(dim), m_(m), dsub_(m ? dim / m : 0) {
+    if (m == 0 || dim % m)
+        throw std::invalid_argument("ProductQuantizer: dim must be a multiple of m");
+}
+
+void ProductQuantizer::train(const float* X, size_t n, unsigned iters, uint32_t seed) {
+    if (n < ksub) throw std::invalid_argument("ProductQuantizer::train: need at least 256 vectors");
+
+    codebooks_.assign((size_t)m_ * ksub * dsub_, 0.0f);
+    std::mt19937 rng(seed);
+    std::vector<float> sub(n * dsub_);
+    std::vector<float> sums((size_t)ksub * dsub_);
+    std::vector<size_t> counts(ksub);
+    std::vector<size_t> perm(n);
+
+    for (unsigned s = 0; s < m_; ++s) {
+        for (size_t i = 0; i < n; ++i)
+            std::copy(X + i * dim_ + s * dsub_, X + i * dim_ + (s + 1) * dsub_, &sub[i * dsub_]);
+
+        float* book = &codebooks_[(size_t)s * ksub * dsub_];
+        std::iota(perm.begin(), perm.end(), 0);
+        std::shuffle(perm.begin(), perm.end(), rng);
+        for (unsigned c = 0; c < ksub; ++c)
+            std::copy(&sub[perm[c] * dsub_], &sub[(perm[c] + 1) * dsub_], book + (size_t)c * dsub_);
+
+        for (unsigned it = 0; it < iters; ++it) {
+            std::fill(sums.begin(), sums.end(), 0.0f);
+            std::fill(counts.begin(), counts.end(), 0);
+            for (size_t i = 0; i < n; ++i) {
+                const unsigned c = nearest(&sub[i * dsub_], book, dsub_);
+                for (unsigned d = 0; d < dsub_; ++d) sums[(size_t)c * dsub_ + d] += sub[i * dsub_ + d];
+                ++counts[c];
+            }
+            for (unsigned c = 0; c < ksub; ++c) {
+                float* cen = book + (size_t)c * dsub_;
+                if (counts[c] == 0) {
+                    // empty cell: restart from a random training subvector
+                    const size_t r = rng() % n;
+                    std::copy(&sub[r * dsub_], &sub[(r + 1) * dsub_], cen);
+                    continue;
+                }
+                for (unsigned d = 0; d < dsub_; ++d) cen[d] = sums[(size_t)c * dsub_ + d] / counts[c];
+            }
+        }
+    }
+}
+
+void ProductQuantizer::encode(const float* X, size_t n, uint8_t* codes) const {
+    for (size_t i = 0; i < n; ++i)
+        for (unsigned s = 0; s < m_; ++s)
+            codes[i * m_ + s] = (uint8_t)nearest(X + i * dim_ + s * dsub_,
+                                                 &codebooks_[(size_t)s * ksub * dsub_], dsub_);
+}
+
+void ProductQuantizer::decode(const uint8_t* codes, size_t n, float* X) const {
+    for (size_t i = 0; i < n; ++i)
+        for (unsigned s = 0; s < m_; ++s) {
+            const float* cen = &codebooks_[((size_t)s * ksub + codes[i * m_ + s]) * dsub_];
+            std::copy(cen, cen + dsub_, X + i * dim_ + s * dsub_);
+        }
+}
+
+void ProductQuantizer::compute_lut(const float* q, float* lut) const {
+    for (unsigned s = 0; s < m_; ++s)
+        for (unsigned c = 0; c < ksub; ++c)
+            lut[s * ksub + c] = twin_dot(q + s * dsub_, &codebooks_[((size_t)s * ksub + c) * dsub_], dsub_);
+}
+
+PqQuantizedLut pq_quantize_lut(const float* lut, unsigned m) {
+    const unsigned ksub = ProductQuantizer::ksub;
+    PqQuantizedLut out;
+    out.table.resize((size_t)m * ksub);
+
+    std::vector<float> lo(m);
+    float range = 0.0f;
+    for (unsigned s = 0; s < m; ++s) {
+        const float* row = lut + (size_t)s * ksub;
+        const auto mm = std::minmax_element(row, row + ksub);
+        lo[s] = *mm.first;
+        range = std::max(range, *mm.second - *mm.first);
+        out.bias += lo[s];
+    }
+    out.scale = range > 0.0f ? 255.0f / range : 1.0f;
+
+    for (unsigned s = 0; s < m; ++s)
+        for (unsigned c = 0; c < ksub; ++c) {
+            const float v = std::round((lut[(size_t)s * ksub + c] - lo[s]) * out.scale);
+            out.table[(size_t)s * ksub + c] = (uint8_t)std::min(255.0f, std::max(0.0f, v));
+        }
+    return out;
+}
+
+void pq_adc_scan_float(const float* lut, unsigned m, const uint8_t* codes, size_t n,
+                       TopK& out, int32_t id_base) {
+    const unsigned ksub = ProductQuantizer::ksub;
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* code = codes + i * m;
+        float s = 0.0f;
+        for (unsigned j = 0; j < m; ++j) s += lut[j * ksub + code[j]];
+        out.push(s, id_base + (int32_t)i);
+    }
+}
+
+void pq_adc_scan_u8(const PqQuantizedLut& lut, unsigned m, const uint8_t* codes, size_t n,
+                    TopK& out, int32_t id_base) {
+    const unsigned ksub = ProductQuantizer::ksub;
+    const uint8_t* T = lut.table.data();
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t* code = codes + i * m;
+        int32_t s = 0;
+        for (unsigned j = 0; j < m; ++j) s += T[j * ksub + code[j]];
+        out.push((float)s, id_base + (int32_t)i);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef __PQ_H__
+#define __PQ_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "topk.h"
+
+// Product quantizer with 8-bit codes: the dim-long vector is cut into m
+// subvectors of dsub = dim / m dims, each replaced by the index of its
+// nearest centroid in a 256-entry sub-codebook.
+class ProductQuantizer {
+public:
+    static const unsigned ksub = 256;
+
+    ProductQuantizer(unsigned dim, unsigned m);
+
+    unsigned dim() const { return dim_; }
+    unsigned m() const { return m_; }
+    unsigned dsub() const { return dsub_; }
+    size_t code_size() const { return m_; }
+
+    // m x ksub x dsub sub-codebooks
+    const std::vector<float>& codebooks() const { return codebooks_; }
+
+    // L2 k-means per subspace on n training vectors
+    void train(const float* X, size_t n, unsigned iters = 10, uint32_t seed = 12262023);
+    void encode(const float* X, size_t n, uint8_t* codes) const;
+    void decode(const uint8_t* codes, size_t n, float* X) const;
+
+    // Inner-product table of one query: lut[s * ksub + c] = <q_s, codebook[s][c]>
+    void compute_lut(const float* q, float* lut) const;
+
+private:
+    unsigned dim_, m_, dsub_;
+    std::vector<float> codebooks_;
+};
+
+// uint8 table in the pq_adc_scan layout. Every entry is shifted by its
+// subspace minimum and scaled by one factor, so a raw kernel score maps back
+// to the float ADC score as raw / scale + bias and the order is preserved
+// up to the 8-bit rounding.
+struct PqQuantizedLut {
+    std::vector<uint8_t> table;   // m x ksub
+    float scale = 1.0f;
+    float bias = 0.0f;            // sum of the subspace minima
+
+    float to_score(int32_t raw) const { return raw / scale + bias; }
+};
+
+PqQuantizedLut pq_quantize_lut(const float* lut, unsigned m);
+
+// Exact float ADC over n codes (host reference)
+void pq_adc_scan_float(const float* lut, unsigned m, const uint8_t* codes, size_t n,
+                       TopK& out, int32_t id_base = 0);
+
+// Bit-exact twin of the pq_adc_scan kernel; scores are the raw integer sums
+void pq_adc_scan_u8(const PqQuantizedLut& lut, unsigned m, const uint8_t* codes, size_t n,
+                    TopK& out, int32_t id_base = 0);
+
+#endif
@@ -0,0 +1,103 @@
+#include "query_feeder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "cpu_twin.h"
+#include "tile_layout.h"
+
+SteadyRunner twin_resident_runner(const SteadyShape& s, const float* a) {
+    auto corpus = std::make_shared<std::vector<float>>(s.a_floats());
+    untile_matrix(a, s.rows, s.dim, 4, 2, corpus->data());
+    auto bt = std::make_shared<std::vector<float>>(s.b_floats());
+    auto q = std::make_shared<std::vector<float>>(s.b_floats());
+    return [s, corpus, bt, q](const float* b, float* out) {
+        // b is dim x cols, the twin wants one query per row
+        untile_matrix(b, s.dim, s.cols, 2, 4, bt->data());
+        for (unsigned d = 0; d < s.dim; ++d)
+            for (unsigned j = 0; j < s.cols; ++j) (*q)[(size_t)j * s.dim + d] = (*bt)[(size_t)d * s.cols + j];
+        twin_matmult_colmax(corpus->data(), s.rows, q->data(), s.cols, s.dim, out, nullptr);
+    };
+}
+
+QueryFeeder::QueryFeeder(const SteadyShape& shape, SteadyRunner run)
+    : shape_(shape), run_(run), out_(shape.out_floats()) {
+    buf_[0].resize(shape.b_floats());
+    buf_[1].resize(shape.b_floats());
+    packer_ = std::thread(&QueryFeeder::packer_loop, this);
+}
+
+QueryFeeder::~QueryFeeder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    packer_.join();
+}
+
+void QueryFeeder::packer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        // at most two batches ahead of the runner, one per buffer
+        cv_.wait(lock, [this] { return stop_ || (packed_ < nbatches_ && packed_ < consumed_ + 2); });
+        if (stop_) return;
+        const size_t i = packed_;
+        const float* Q = q_;
+        const size_t nq = nq_;
+        lock.unlock();
+        pack(Q, nq, i * shape_.cols, buf_[i % 2].data());
+        lock.lock();
+        packed_ = i + 1;
+        cv_.notify_all();
+    }
+}
+
+void QueryFeeder::pack(const float* Q, size_t nq, size_t first, float* b) const {
+    const SteadyShape& s = shape_;
+    std::vector<float> bt(s.b_floats(), 0.0f);
+    const size_t cnt = std::min<size_t>(s.cols, nq - first);
+    for (size_t j = 0; j < cnt; ++j)
+        for (unsigned d = 0; d < s.dim; ++d) bt[(size_t)d * s.cols + j] = Q[(first + j) * s.dim + d];
+    tile_matrix(bt.data(), s.dim, s.cols, 2, 4, b);
+}
+
+void QueryFeeder::feed(const float* Q, size_t nq, float* best) {
+    const SteadyShape& s = shape_;
+    const size_t nbatches = (nq + s.cols - 1) / s.cols;
+    if (!nbatches) return;
+
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        q_ = Q;
+        nq_ = nq;
+        nbatches_ = nbatches;
+        packed_ = 0;
+        consumed_ = 0;
+    }
+    cv_.notify_all();
+    for (size_t i = 0; i < nbatches; ++i) {
+        // the packer fills the other buffer with batch i + 1 while this one runs
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this, i] { return packed_ > i; });
+        }
+        run_(buf_[i % 2].data(), out_.data());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            consumed_ = i + 1;
+        }
+        cv_.notify_all();
+
+        const size_t first = i * s.cols;
+        const size_t cnt = std::min<size_t>(s.cols, nq - first);
+        std::copy(out_.begin(), out_.begin() + cnt, best + first);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    batches_ += nbatches;
+    queries_ += nq;
+    seconds_ += std::chrono::duration<double>(t1 - t0).count();
+}
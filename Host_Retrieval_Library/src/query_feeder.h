@@ -0,0 +1,79 @@
+#ifndef __QUERY_FEEDER_H__
+#define __QUERY_FEEDER_H__
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Window shape of the STEADY_STATE graph (system_settings.h): one resident
+// corpus block, a query batch per graph iteration
+struct SteadyShape {
+    unsigned rows = 128;      // F_Ra corpus rows, resident
+    unsigned dim = 32;        // F_Ca
+    unsigned cols = 32;       // F_Cb queries per batch
+
+    size_t a_floats() const { return (size_t)rows * dim; }
+    size_t b_floats() const { return (size_t)dim * cols; }
+    size_t out_floats() const { return cols; }
+};
+
+// One graph iteration: scores the 2x4-tiled query batch b against the
+// resident corpus, out gets the column maxima. The STEADY_STATE graph is
+// simulation-only (its project links no PL movers or host), so
+// twin_resident_runner is the only runner.
+typedef std::function<void(const float* b, float* out)> SteadyRunner;
+
+// Twin of matmult_float_resident on a 4x2-tiled corpus block a, which is
+// copied and kept like the kernel keeps its A buffer
+SteadyRunner twin_resident_runner(const SteadyShape& s, const float* a);
+
+// Feeds query batches continuously to a graph whose corpus is resident.
+// While batch i runs, a packer thread owned by the feeder packs batch i + 1
+// into the other of two buffers, mirroring the ping-pong B buffers of the
+// kernel.
+class QueryFeeder {
+public:
+    QueryFeeder(const SteadyShape& shape, SteadyRunner run);
+    ~QueryFeeder();
+
+    QueryFeeder(const QueryFeeder&) = delete;
+    QueryFeeder& operator=(const QueryFeeder&) = delete;
+
+    // Scores nq row-major queries, one best score per query in best. The
+    // last batch is zero padded. Batches already fed stay counted.
+    void feed(const float* Q, size_t nq, float* best);
+
+    size_t batches() const { return batches_; }
+    size_t queries() const { return queries_; }
+    double seconds() const { return seconds_; }
+    double qps() const { return seconds_ > 0.0 ? queries_ / seconds_ : 0.0; }
+
+private:
+    void pack(const float* Q, size_t nq, size_t first, float* b) const;
+    void packer_loop();
+
+    SteadyShape shape_;
+    SteadyRunner run_;
+    std::vector<float> buf_[2];
+    std::vector<float> out_;
+
+    // handoff with the packer: batch i goes to buf_[i % 2] once batch i - 2
+    // has run; all guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    const float* q_ = nullptr;
+    size_t nq_ = 0;
+    size_t nbatches_ = 0;
+    size_t packed_ = 0;
+    size_t consumed_ = 0;
+    bool stop_ = false;
+    std::thread packer_;
+    size_t batches_ = 0;
+    size_t queries_ = 0;
+    double seconds_ = 0.0;
+};
+
+#endif
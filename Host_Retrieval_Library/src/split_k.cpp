@@ -0,0 +1,55 @@
+#include "split_k.h"
+
+#include <vector>
+
+#include "tile_layout.h"
+
+void cascade_pack_rows(const CascadeShape& s, const float* X, float* a) {
+    std::vector<float> piece(s.a_floats());
+    const unsigned dim = s.dim();
+    for (unsigned t = 0; t < s.len; ++t) {
+        for (unsigned r = 0; r < s.rows; ++r)
+            for (unsigned d = 0; d < s.slice; ++d)
+                piece[(size_t)r * s.slice + d] = X[(size_t)r * dim + t * s.slice + d];
+        tile_matrix(piece.data(), s.rows, s.slice, 4, 2, a + t * s.a_floats());
+    }
+}
+
+void cascade_pack_queries(const CascadeShape& s, const float* Q, float* b) {
+    std::vector<float> piece(s.b_floats());
+    const unsigned dim = s.dim();
+    for (unsigned t = 0; t < s.len; ++t) {
+        for (unsigned d = 0; d < s.slice; ++d)
+            for (unsigned j = 0; j < s.cols; ++j)
+                piece[(size_t)d * s.cols + j] = Q[(size_t)j * dim + t * s.slice + d];
+        tile_matrix(piece.data(), s.slice, s.cols, 2, 4, b + t * s.b_floats());
+    }
+}
+
+void twin_matmult_cascade(const CascadeShape& s, const float* a, const float* b, float* out) {
+    std::vector<float> C((size_t)s.rows * s.cols, 0.0f);
+    std::vector<float> A(s.a_floats()), B(s.b_floats());
+    for (unsigned t = 0; t < s.len; ++t) {
+        untile_matrix(a + t * s.a_floats(), s.rows, s.slice, 4, 2, A.data());
+        untile_matrix(b + t * s.b_floats(), s.slice, s.cols, 2, 4, B.data());
+        for (unsigned r = 0; r < s.rows; ++r)
+            for (unsigned j = 0; j < s.cols; ++j) {
+                float v = C[(size_t)r * s.cols + j];
+                for (unsigned d = 0; d < s.slice; ++d)
+                    v += A[(size_t)r * s.slice + d] * B[(size_t)d * s.cols + j];
+                C[(size_t)r * s.cols + j] = v;
+            }
+    }
+    for (unsigned j = 0; j < s.cols; ++j) {
+        float best = -1e30f;
+        float arg = -1.0f;
+        for (unsigned r = 0; r < s.rows; ++r) {
+            if (C[(size_t)r * s.cols + j] > best) {
+                best = C[(size_t)r * s.cols + j];
+                arg = (float)r;
+            }
+        }
+        out[j * 2] = best;
+        out[j * 2 + 1] = arg;
+    }
+}
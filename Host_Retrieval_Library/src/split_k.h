@@ -0,0 +1,33 @@
+#ifndef __SPLIT_K_H__
+#define __SPLIT_K_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// Window shape of the cascade split-K graph (system_settings.h): len tiles,
+// each holding a slice-wide piece of every corpus row and query
+struct CascadeShape {
+    unsigned len = 24;        // CASC_LEN
+    unsigned rows = 64;       // CASC_ROWS corpus rows per invocation
+    unsigned slice = 32;      // F_Ca dimensions per tile
+    unsigned cols = 32;       // F_Cb queries per invocation
+
+    unsigned dim() const { return len * slice; }
+    size_t a_floats() const { return (size_t)rows * slice; }
+    size_t b_floats() const { return (size_t)slice * cols; }
+    size_t out_floats() const { return (size_t)cols * 2; }
+};
+
+// Row-major rows x dim() corpus block -> len 4x2-tiled A windows, tile i
+// getting dimensions [i * slice, (i + 1) * slice); a holds len * a_floats()
+void cascade_pack_rows(const CascadeShape& s, const float* X, float* a);
+
+// Row-major cols x dim() queries -> len 2x4-tiled B windows, one query per
+// column; b holds len * b_floats()
+void cascade_pack_queries(const CascadeShape& s, const float* Q, float* b);
+
+// Twin of one chain invocation on packed windows: the K-slices are summed
+// in chain order like the cascade, out gets (max, argmax row) per query
+void twin_matmult_cascade(const CascadeShape& s, const float* a, const float* b, float* out);
+
+#endif
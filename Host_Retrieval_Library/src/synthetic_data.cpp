@@ -0,0 +1,35 @@
+#include "synthetic_data.h"
+
+#include <cmath>
+#include <random>
+
+static void normalize(float* v, unsigned dim) {
+    float s = 0.0f;
+    for (unsigned i = 0; i < dim; ++i) s += v[i] * v[i];
+    s = std::sqrt(s);
+    if (s > 0.0f)
+        for (unsigned i = 0; i < dim; ++i) v[i] /= s;
+}
+
+std::vector<float> make_clustered(size_t n, unsigned dim, unsigned nclusters, float spread,
+                                  uint32_t center_seed, uint32_t sample_seed) {
+    std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+    std::mt19937 crng(center_seed);
+    std::vector<float> centers((size_t)nclusters * dim);
+    for (unsigned c = 0; c < nclusters; ++c) {
+        for (unsigned d = 0; d < dim; ++d) centers[(size_t)c * dim + d] = gauss(crng);
+        normalize(&centers[(size_t)c * dim], dim);
+    }
+
+    std::mt19937 rng(sample_seed);
+    std::uniform_int_distribution<unsigned> pick(0, nclusters - 1);
+    std::vector<float> X(n * dim);
+    for (size_t i = 0; i < n; ++i) {
+        const float* c = &centers[(size_t)pick(rng) * dim];
+        float* x = &X[i * dim];
+        for (unsigned d = 0; d < dim; ++d) x[d] = c[d] + spread * gauss(rng);
+        normalize(x, dim);
+    }
+    return X;
+}
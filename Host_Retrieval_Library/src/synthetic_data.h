@@ -0,0 +1,15 @@
+#ifndef __SYNTHETIC_DATA_H__
+#define __SYNTHETIC_DATA_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// n unit-norm vectors drawn around nclusters random unit centers with
+// per-coordinate gaussian noise of stddev spread, row-major n x dim.
+// Queries drawn with another seed from the same centers follow the same
+// distribution, which is what IVF recall depends on.
+std::vector<float> make_clustered(size_t n, unsigned dim, unsigned nclusters, float spread,
+                                  uint32_t center_seed, uint32_t sample_seed);
+
+#endif
@@ -0,0 +1,140 @@
+#include "tile_layout.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static void check_shape(size_t rows, size_t cols, unsigned R, unsigned C) {
+    if (!R || !C || rows % R || cols % C)
+        throw std::invalid_argument("tile_layout: matrix is not whole R x C tiles");
+}
+
+// Copies of one C-wide tile row with C known at compile time, so the
+// compiler turns them into vector moves instead of memcpy calls
+template <typename T, unsigned C>
+static void copy_run(const T* src, T* dst) {
+    for (unsigned c = 0; c < C; ++c) dst[c] = src[c];
+}
+
+template <typename T>
+static void copy_run(const T* src, T* dst, unsigned C) {
+    switch (C) {
+    case 2: copy_run<T, 2>(src, dst); break;
+    case 4: copy_run<T, 4>(src, dst); break;
+    case 8: copy_run<T, 8>(src, dst); break;
+    case 16: copy_run<T, 16>(src, dst); break;
+    default: std::memcpy(dst, src, C * sizeof(T));
+    }
+}
+
+// Block rows [b, e): source rows are read front to back, every tile row
+// lands at its place inside the block row's run of the output
+template <typename T>
+static void tile_block_rows(const T* src, size_t cols, unsigned R, unsigned C, T* dst,
+                            size_t b, size_t e) {
+    const size_t run = (size_t)R * cols;
+    for (size_t blk = b; blk < e; ++blk)
+        for (unsigned rr = 0; rr < R; ++rr) {
+            const T* s = src + (blk * R + rr) * cols;
+            T* d = dst + blk * run + (size_t)rr * C;
+            for (size_t c = 0; c < cols; c += C, d += (size_t)R * C) copy_run(s + c, d, C);
+        }
+}
+
+template <typename T>
+static void untile_block_rows(const T* src, size_t cols, unsigned R, unsigned C, T* dst,
+                              size_t b, size_t e) {
+    const size_t run = (size_t)R * cols;
+    for (size_t blk = b; blk < e; ++blk)
+        for (unsigned rr = 0; rr < R; ++rr) {
+            T* d = dst + (blk * R + rr) * cols;
+            const T* s = src + blk * run + (size_t)rr * C;
+            for (size_t c = 0; c < cols; c += C, s += (size_t)R * C) copy_run(s, d + c, C);
+        }
+}
+
+template <typename Fn>
+static void split_block_rows(size_t nblk, unsigned threads, Fn fn) {
+    if (!threads) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = (unsigned)std::min<size_t>(threads, std::max<size_t>(nblk, 1));
+    if (threads == 1) {
+        fn(0, nblk);
+        return;
+    }
+    std::vector<std::thread> pool;
+    const size_t chunk = (nblk + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        const size_t b = t * chunk, e = std::min(nblk, b + chunk);
+        if (b >= e) break;
+        pool.emplace_back(fn, b, e);
+    }
+    for (std::thread& th : pool) th.join();
+}
+
+template <typename T>
+void tile_matrix(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst) {
+    check_shape(rows, cols, R, C);
+    tile_block_rows(src, cols, R, C, dst, 0, rows / R);
+}
+
+template <typename T>
+void untile_matrix(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst) {
+    check_shape(rows, cols, R, C);
+    untile_block_rows(src, cols, R, C, dst, 0, rows / R);
+}
+
+template <typename T>
+void tile_matrix_mt(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst,
+                    unsigned threads) {
+    check_shape(rows, cols, R, C);
+    split_block_rows(rows / R, threads,
+                     [&](size_t b, size_t e) { tile_block_rows(src, cols, R, C, dst, b, e); });
+}
+
+template <typename T>
+void untile_matrix_mt(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst,
+                      unsigned threads) {
+    check_shape(rows, cols, R, C);
+    split_block_rows(rows / R, threads,
+                     [&](size_t b, size_t e) { untile_block_rows(src, cols, R, C, dst, b, e); });
+}
+
+#define INSTANTIATE_LAYOUT(T)                                                                    \
+    template void tile_matrix<T>(const T*, size_t, size_t, unsigned, unsigned, T*);              \
+    template void untile_matrix<T>(const T*, size_t, size_t, unsigned, unsigned, T*);            \
+    template void tile_matrix_mt<T>(const T*, size_t, size_t, unsigned, unsigned, T*, unsigned); \
+    template void untile_matrix_mt<T>(const T*, size_t, size_t, unsigned, unsigned, T*, unsigned);
+
+INSTANTIATE_LAYOUT(float)
+INSTANTIATE_LAYOUT(int32_t)
+INSTANTIATE_LAYOUT(int16_t)
+INSTANTIATE_LAYOUT(int8_t)
+
+MappedFile::MappedFile(const std::string& path, size_t bytes) : bytes_(bytes) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) throw std::system_error(errno, std::generic_category(), "MappedFile: " + path);
+    if (::ftruncate(fd_, (off_t)bytes) != 0 ||
+        (data_ = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)) == MAP_FAILED) {
+        const int err = errno;
+        ::close(fd_);
+        throw std::system_error(err, std::generic_category(), "MappedFile: " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    ::munmap(data_, bytes_);
+    ::close(fd_);
+}
+
+void MappedFile::sync() {
+    if (::msync(data_, bytes_, MS_SYNC) != 0)
+        throw std::system_error(errno, std::generic_category(), "MappedFile: msync");
+}
@@ -0,0 +1,62 @@
+#ifndef __TILE_LAYOUT_H__
+#define __TILE_LAYOUT_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Row-major rows x cols -> R x C blocks, block rows outer, the order
+// write_file.py::mat2file_tile writes and the aie::mmul kernels load.
+// rows must be a multiple of R and cols a multiple of C. Instantiated for
+// float, int32_t, int16_t and int8_t.
+template <typename T>
+void tile_matrix(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst);
+
+// Inverse of tile_matrix
+template <typename T>
+void untile_matrix(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst);
+
+// The same conversions split over threads (0 = hardware concurrency). A
+// block row of R source rows is one contiguous run of the tiled output, so
+// a corpus tiled in one call equals its F_Ra-row blocks tiled one by one
+// and each thread writes its own range of dst.
+template <typename T>
+void tile_matrix_mt(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst,
+                    unsigned threads = 0);
+template <typename T>
+void untile_matrix_mt(const T* src, size_t rows, size_t cols, unsigned R, unsigned C, T* dst,
+                      unsigned threads = 0);
+
+// A (M x K) and B (K x N) tile shapes per dtype, as data/gen_test_data.py
+// writes them for aie::mmul
+template <typename T> struct MmulTile;
+template <> struct MmulTile<float>   { static const unsigned M = 4, K = 2, N = 4; };
+template <> struct MmulTile<int32_t> { static const unsigned M = 4, K = 2, N = 4; };
+template <> struct MmulTile<int16_t> { static const unsigned M = 4, K = 4, N = 8; };
+template <> struct MmulTile<int8_t>  { static const unsigned M = 4, K = 8, N = 4; };
+
+// Writable shared mapping of a file of bytes bytes, created or resized, so
+// a corpus can be tiled straight into the file the DMA movers read. For
+// device memory pass bo.map<T*>() of an xrt::bo as dst instead and sync
+// the bo to the device afterwards; the layout calls never copy through a
+// staging buffer.
+class MappedFile {
+public:
+    MappedFile(const std::string& path, size_t bytes);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void* data() const { return data_; }
+    size_t size() const { return bytes_; }
+    template <typename T> T* as() const { return static_cast<T*>(data_); }
+    // flush dirty pages to the file
+    void sync();
+
+private:
+    int fd_ = -1;
+    void* data_ = nullptr;
+    size_t bytes_ = 0;
+};
+
+#endif
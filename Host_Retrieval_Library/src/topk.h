@@ -0,0 +1,47 @@
+#ifndef __TOPK_H__
+#define __TOPK_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// One retrieval hit: inner-product score and global vector id
+struct ScoredId {
+    float score;
+    int32_t id;
+};
+
+// Running top-K list, best score first. Equal scores keep arrival order,
+// which is what the insertion lists in the AIE kernels do.
+class TopK {
+public:
+    explicit TopK(unsigned k = 1) : k_(k) { items_.reserve(k + 1); }
+
+    unsigned k() const { return k_; }
+    bool full() const { return items_.size() == k_; }
+
+    // Score an entry must beat to be inserted
+    float threshold() const { return full() ? items_.back().score : -1e30f; }
+
+    void push(float score, int32_t id) {
+        if (full() && score <= items_.back().score) return;
+        auto it = std::upper_bound(items_.begin(), items_.end(), score,
+                                   [](float s, const ScoredId& e) { return s > e.score; });
+        items_.insert(it, ScoredId{score, id});
+        if (items_.size() > k_) items_.pop_back();
+    }
+
+    void merge(const TopK& other) {
+        for (const ScoredId& e : other.items_) push(e.score, e.id);
+    }
+
+    void clear() { items_.clear(); }
+
+    const std::vector<ScoredId>& items() const { return items_; }
+
+private:
+    unsigned k_;
+    std::vector<ScoredId> items_;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "vecs_io.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+static std::ifstream open_input(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot open " + path);
+    return f;
+}
+
+static bool ends_with(const std::string& s, const char* suffix) {
+    const size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// Reads records of an int32 dimension and dim components of type T into
+// out, converted to U
+template <typename T, typename U>
+static size_t read_records(const std::string& path, size_t max_n, unsigned& dim, std::vector<U>& out) {
+    std::ifstream f = open_input(path);
+    std::vector<T> row;
+    size_t n = 0;
+    int32_t d;
+    while ((!max_n || n < max_n) && f.read(reinterpret_cast<char*>(&d), sizeof(d))) {
+        if (d <= 0 || (n && (unsigned)d != dim)) throw std::runtime_error(path + ": bad vector dimension");
+        dim = (unsigned)d;
+        row.resize(dim);
+        if (!f.read(reinterpret_cast<char*>(row.data()), dim * sizeof(T)))
+            throw std::runtime_error(path + ": truncated vector");
+        out.insert(out.end(), row.begin(), row.end());
+        ++n;
+    }
+    return n;
+}
+
+VecSet read_fvecs(const std::string& path, size_t max_n) {
+    VecSet v;
+    v.n = read_records<float>(path, max_n, v.dim, v.data);
+    return v;
+}
+
+VecSet read_bvecs(const std::string& path, size_t max_n) {
+    VecSet v;
+    v.n = read_records<uint8_t>(path, max_n, v.dim, v.data);
+    return v;
+}
+
+IdSet read_ivecs(const std::string& path, size_t max_n) {
+    IdSet v;
+    v.n = read_records<int32_t>(path, max_n, v.dim, v.data);
+    return v;
+}
+
+void write_ivecs(const std::string& path, const int32_t* ids, size_t n, unsigned dim) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("cannot create " + path);
+    const int32_t d = (int32_t)dim;
+    for (size_t i = 0; i < n; ++i) {
+        f.write(reinterpret_cast<const char*>(&d), sizeof(d));
+        f.write(reinterpret_cast<const char*>(ids + i * dim), dim * sizeof(int32_t));
+    }
+    if (!f) throw std::runtime_error("cannot write " + path);
+}
+
+// Value of key in the header dict, up to the next ',' or '}' outside
+// parentheses
+static std::string npy_field(const std::string& header, const std::string& key, const std::string& path) {
+    const size_t k = header.find("'" + key + "'");
+    if (k == std::string::npos) throw std::runtime_error(path + ": npy header lacks " + key);
+    size_t b = header.find(':', k) + 1;
+    int depth = 0;
+    size_t e = b;
+    for (; e < header.size(); ++e) {
+        const char c = header[e];
+        if (c == '(') ++depth;
+        if (c == ')') --depth;
+        if (depth == 0 && (c == ',' || c == '}')) break;
+    }
+    while (b < e && header[b] == ' ') ++b;
+    return header.substr(b, e - b);
+}
+
+template <typename T>
+static void npy_convert(std::ifstream& f, size_t count, std::vector<float>& out, const std::string& path) {
+    std::vector<T> raw(count);
+    if (!f.read(reinterpret_cast<char*>(raw.data()), count * sizeof(T)))
+        throw std::runtime_error(path + ": truncated npy data");
+    out.assign(raw.begin(), raw.end());
+}
+
+VecSet read_npy(const std::string& path, size_t max_n) {
+    std::ifstream f = open_input(path);
+    char magic[8];
+    if (!f.read(magic, 8) || std::memcmp(magic, "\x93NUMPY", 6) != 0)
+        throw std::runtime_error(path + ": not an npy file");
+    uint32_t hlen = 0;
+    if (magic[6] == 1) {
+        uint16_t h;
+        f.read(reinterpret_cast<char*>(&h), 2);
+        hlen = h;
+    } else {
+        f.read(reinterpret_cast<char*>(&hlen), 4);
+    }
+    std::string header(hlen, '\0');
+    if (!f.read(&header[0], hlen)) throw std::runtime_error(path + ": truncated npy header");
+
+    if (npy_field(header, "fortran_order", path) != "False")
+        throw std::runtime_error(path + ": only C-order npy arrays are supported");
+    const std::string descr = npy_field(header, "descr", path);
+    const std::string shape = npy_field(header, "shape", path);
+    size_t rows = 0, cols = 0;
+    if (std::sscanf(shape.c_str(), "(%zu, %zu)", &rows, &cols) != 2)
+        throw std::runtime_error(path + ": expected a 2-D array, shape " + shape);
+
+    VecSet v;
+    v.n = max_n && max_n < rows ? max_n : rows;
+    v.dim = (unsigned)cols;
+    const size_t count = v.n * cols;
+    if (descr == "'<f4'") npy_convert<float>(f, count, v.data, path);
+    else if (descr == "'<f8'") npy_convert<double>(f, count, v.data, path);
+    else if (descr == "'|i1'") npy_convert<int8_t>(f, count, v.data, path);
+    else if (descr == "'|u1'") npy_convert<uint8_t>(f, count, v.data, path);
+    else if (descr == "'<i4'") npy_convert<int32_t>(f, count, v.data, path);
+    else throw std::runtime_error(path + ": unsupported npy dtype " + descr);
+    return v;
+}
+
+VecSet read_vectors(const std::string& path, size_t max_n) {
+    if (ends_with(path, ".fvecs")) return read_fvecs(path, max_n);
+    if (ends_with(path, ".bvecs")) return read_bvecs(path, max_n);
+    if (ends_with(path, ".npy")) return read_npy(path, max_n);
+    throw std::runtime_error(path + ": unknown vector file extension");
+}
@@ -0,0 +1,38 @@
+#ifndef __VECS_IO_H__
+#define __VECS_IO_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// n row-major vectors of dimension dim
+struct VecSet {
+    size_t n = 0;
+    unsigned dim = 0;
+    std::vector<float> data;
+};
+
+struct IdSet {
+    size_t n = 0;
+    unsigned dim = 0;
+    std::vector<int32_t> data;
+};
+
+// ANN benchmark formats (TEXMEX): every vector is an int32 dimension
+// followed by its components, float32 for fvecs, uint8 for bvecs (widened
+// to float here) and int32 for ivecs. max_n > 0 stops after max_n vectors.
+// Malformed files throw std::runtime_error.
+VecSet read_fvecs(const std::string& path, size_t max_n = 0);
+VecSet read_bvecs(const std::string& path, size_t max_n = 0);
+IdSet read_ivecs(const std::string& path, size_t max_n = 0);
+void write_ivecs(const std::string& path, const int32_t* ids, size_t n, unsigned dim);
+
+// 2-D C-order .npy dump (format 1.0 to 3.0) of float32, float64, int8,
+// uint8 or int32, converted to float
+VecSet read_npy(const std::string& path, size_t max_n = 0);
+
+// Picks the reader by extension: .fvecs, .bvecs or .npy
+VecSet read_vectors(const std::string& path, size_t max_n = 0);
+
+#endif
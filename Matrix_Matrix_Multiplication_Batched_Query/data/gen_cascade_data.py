@@ -0,0 +1,36 @@
+# Copyright (C) 2023 Advanced Micro Devices, Inc
+#
+# SPDX-License-Identifier: MIT
+
+import numpy as np
+from write_file import mat2file_tile
+
+# must match system_settings.h
+F_Ca = 32
+F_Cb = 32
+CASC_LEN = 24
+CASC_ROWS = 64
+CASC_DIM = CASC_LEN * F_Ca
+
+
+def main():
+    """Split 768-dim corpus rows and queries into per-tile K-slices"""
+    np.random.seed(12262023)
+    a = np.float32(np.random.randn(CASC_ROWS, CASC_DIM))
+    b = np.float32(np.random.randn(CASC_DIM, F_Cb))
+
+    for i in range(CASC_LEN):
+        cols = slice(i * F_Ca, (i + 1) * F_Ca)
+        mat2file_tile(np.ascontiguousarray(a[:, cols]), 4, 2, f"casc_a_{i}.txt")
+        mat2file_tile(np.ascontiguousarray(b[cols, :]), 2, 4, f"casc_b_{i}.txt")
+
+    c = np.matmul(a, b)
+    with open("ref_casc_float.txt", 'w', encoding="utf-8") as f:
+        for j in range(F_Cb):
+            r = int(np.argmax(c[:, j]))
+            v = np.format_float_scientific(c[r, j], min_digits=9)
+            f.write(f'{v} {float(r)}\n')
+
+
+if __name__ == '__main__':
+    main()
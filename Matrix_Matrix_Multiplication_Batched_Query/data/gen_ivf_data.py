@@ -0,0 +1,52 @@
+# Copyright (C) 2023 Advanced Micro Devices, Inc
+#
+# SPDX-License-Identifier: MIT
+
+import numpy as np
+from write_file import mat2file_tile
+
+# must match system_settings.h
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+IVF_NLIST = 1024
+IVF_NPROBE = 8
+
+
+def normalize(x: np.ndarray) -> np.ndarray:
+    return np.float32(x / np.linalg.norm(x, axis=1, keepdims=True))
+
+
+def block_topk(scores: np.ndarray, base: int):
+    """Per query column, the IVF_NPROBE best (score, id) of one block."""
+    out = []
+    for j in range(scores.shape[1]):
+        col = scores[:, j]
+        # stable sort keeps the lower row first on ties, like the kernel
+        order = np.argsort(-col, kind='stable')[:IVF_NPROBE]
+        out.append([(col[r], base + r) for r in order])
+    return out
+
+
+def main():
+    """Write centroid blocks, repeated query batch and the per-block golden"""
+    np.random.seed(12262023)
+    centroids = normalize(np.random.randn(IVF_NLIST, F_Ca))
+    queries = normalize(np.random.randn(F_Cb, F_Ca))
+    b = np.ascontiguousarray(queries.T)   # F_Ca x F_Cb, one query per column
+
+    num_blocks = IVF_NLIST // F_Ra
+    mat2file_tile(centroids, 4, 2, "ivf_centroids_float.txt")
+    mat2file_tile(np.vstack([b] * num_blocks), 2, 4, "ivf_queries_float.txt")
+
+    with open("ref_ivf_probe_float.txt", 'w', encoding="utf-8") as f:
+        for blk in range(num_blocks):
+            a = centroids[blk * F_Ra:(blk + 1) * F_Ra]
+            for col in block_topk(np.matmul(a, b), blk * F_Ra):
+                for score, cid in col:
+                    v = np.format_float_scientific(score, min_digits=9)
+                    f.write(f'{v} {float(cid)}\n')
+
+
+if __name__ == '__main__':
+    main()
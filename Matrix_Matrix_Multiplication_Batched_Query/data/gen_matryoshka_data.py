@@ -0,0 +1,47 @@
+# Copyright (C) 2023 Advanced Micro Devices, Inc
+#
+# SPDX-License-Identifier: MIT
+
+import numpy as np
+from write_file import mat2file_tile
+
+# must match system_settings.h
+F_Cb = 32
+MRL_DIM = 64
+MRL_FULL_DIM = 768
+MRL_ROWS = 64
+MRL_BLOCKS = 16
+MRL_TOPR = 16
+
+
+def matryoshka_like(rows: int) -> np.ndarray:
+    """Unit vectors whose energy decays over the dimensions, so a leading
+    slice already ranks well, like Matryoshka-trained embeddings"""
+    x = np.random.randn(rows, MRL_FULL_DIM) / np.sqrt(1.0 + np.arange(MRL_FULL_DIM) / 16.0)
+    return np.float32(x / np.linalg.norm(x, axis=1, keepdims=True))
+
+
+def main():
+    """Write the leading-dim corpus slices, repeated query slices and the
+    per-block candidate golden"""
+    np.random.seed(12262023)
+    corpus = matryoshka_like(MRL_BLOCKS * MRL_ROWS)
+    queries = matryoshka_like(F_Cb)
+    a = np.ascontiguousarray(corpus[:, :MRL_DIM])
+    b = np.ascontiguousarray(queries[:, :MRL_DIM].T)
+
+    mat2file_tile(a, 4, 2, "mrl_slices_float.txt")
+    mat2file_tile(np.vstack([b] * MRL_BLOCKS), 2, 4, "mrl_queries_float.txt")
+
+    with open("ref_mrl_float.txt", 'w', encoding="utf-8") as f:
+        for blk in range(MRL_BLOCKS):
+            scores = np.matmul(a[blk * MRL_ROWS:(blk + 1) * MRL_ROWS], b)
+            for j in range(F_Cb):
+                # stable sort keeps the lower row first on ties, like the kernel
+                for r in np.argsort(-scores[:, j], kind='stable')[:MRL_TOPR]:
+                    v = np.format_float_scientific(scores[r, j], min_digits=9)
+                    f.write(f'{v} {float(blk * MRL_ROWS + r)}\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,49 @@
+# Copyright (C) 2023 Advanced Micro Devices, Inc
+#
+# SPDX-License-Identifier: MIT
+
+import numpy as np
+from write_file import mat2file_tile
+
+# must match system_settings.h
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+MAXSIM_DOCS = 64
+MAXSIM_TOPK = 8
+
+
+def normalize(x: np.ndarray) -> np.ndarray:
+    return np.float32(x / np.linalg.norm(x, axis=1, keepdims=True))
+
+
+def pad_document(tokens: np.ndarray) -> np.ndarray:
+    """Pad to F_Ra tokens by repeating the first one; duplicates never
+    change a per-query-token maximum, zero rows would"""
+    pad = np.repeat(tokens[:1], F_Ra - tokens.shape[0], axis=0)
+    return np.vstack([tokens, pad])
+
+
+def main():
+    """Write MAXSIM_DOCS padded documents, one query and the top-K golden"""
+    np.random.seed(12262023)
+    lengths = np.random.randint(F_Ra // 4, F_Ra + 1, MAXSIM_DOCS)
+    docs = [pad_document(normalize(np.random.randn(n, F_Ca))) for n in lengths]
+    query = normalize(np.random.randn(F_Cb, F_Ca))
+    b = np.ascontiguousarray(query.T)     # F_Ca x F_Cb, one token per column
+
+    mat2file_tile(np.vstack(docs), 4, 2, "maxsim_docs_float.txt")
+    mat2file_tile(b, 2, 4, "maxsim_query_float.txt")
+
+    scores = np.array([np.matmul(d, b).max(axis=0).sum(dtype=np.float32)
+                       for d in docs], dtype=np.float32)
+    # stable sort keeps the earlier document first on ties, like the kernel
+    order = np.argsort(-scores, kind='stable')[:MAXSIM_TOPK]
+    with open("ref_maxsim_float.txt", 'w', encoding="utf-8") as f:
+        for d in order:
+            v = np.format_float_scientific(scores[d], min_digits=9)
+            f.write(f'{v} {float(d)}\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,69 @@
+# Copyright (C) 2023 Advanced Micro Devices, Inc
+#
+# SPDX-License-Identifier: MIT
+
+import numpy as np
+from write_file import mat2file_tile
+
+# must match system_settings.h
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+PRUNE_BLOCKS = 16
+PRUNE_TOPK = 8
+N = 4                   # query columns per mmul block
+
+
+def skewed_corpus(rows: int) -> np.ndarray:
+    """Random directions with log-normal norms, as MIPS corpora have"""
+    x = np.random.randn(rows, F_Ca)
+    x /= np.linalg.norm(x, axis=1, keepdims=True)
+    return np.float32(x * np.random.lognormal(0.0, 0.5, (rows, 1)))
+
+
+def main():
+    """Write the norm-sorted corpus blocks, repeated queries, block norms,
+    and the top-K lists plus skip count the scan ends with"""
+    np.random.seed(12262023)
+    corpus = skewed_corpus(PRUNE_BLOCKS * F_Ra)
+    norms = np.linalg.norm(corpus, axis=1)
+    order = np.argsort(-norms, kind='stable')   # host reorder, see norm_prune.h
+    corpus, norms = corpus[order], norms[order]
+    queries = np.float32(np.random.randn(F_Cb, F_Ca))
+    b = np.ascontiguousarray(queries.T)
+
+    block_max = norms.reshape(PRUNE_BLOCKS, F_Ra).max(axis=1)
+    mat2file_tile(corpus, 4, 2, "prune_a_float.txt")
+    mat2file_tile(np.vstack([b] * PRUNE_BLOCKS), 2, 4, "prune_b_float.txt")
+    with open("prune_norms_float.txt", 'w', encoding="utf-8") as f:
+        for v in block_max:
+            f.write(f'{np.format_float_scientific(np.float32(v), min_digits=9)}\n')
+
+    # the kernel's scan: squared bounds checked per group of N columns
+    q2 = (b * b).sum(axis=0)
+    top = [[] for _ in range(F_Cb)]
+    skipped = 0
+    for blk in range(PRUNE_BLOCKS):
+        scores = corpus[blk * F_Ra:(blk + 1) * F_Ra] @ b
+        m2 = np.float32(block_max[blk]) ** 2
+        for jb in range(F_Cb // N):
+            cols = range(jb * N, (jb + 1) * N)
+            kth = [top[j][PRUNE_TOPK - 1][0] if len(top[j]) == PRUNE_TOPK else -1e30 for j in cols]
+            if not any(k < 0 or q2[j] * m2 > k * k for j, k in zip(cols, kth)):
+                skipped += 1
+                continue
+            for j in cols:
+                top[j] += [(scores[r, j], blk * F_Ra + r) for r in range(F_Ra)]
+                top[j] = sorted(top[j], key=lambda e: -e[0])[:PRUNE_TOPK]
+
+    with open("ref_prune_float.txt", 'w', encoding="utf-8") as f:
+        for j in range(F_Cb):
+            for score, row in top[j]:
+                v = np.format_float_scientific(score, min_digits=9)
+                f.write(f'{v} {float(row)}\n')
+        f.write(f'{float(skipped)}\n')
+    print(f"skipped {skipped} of {PRUNE_BLOCKS * F_Cb // N} (block, column group) pairs")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,40 @@
+# Copyright (C) 2023 Advanced Micro Devices, Inc
+#
+# SPDX-License-Identifier: MIT
+
+import numpy as np
+from write_file import mat2file_tile
+
+# must match system_settings.h
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+FG_REPLICAS = 4
+
+
+def main():
+    """Write one corpus slice per replica of TopGraph, the shared query
+    batch, and the (max, replica) pairs the merge chain ends with"""
+    np.random.seed(12262023)
+    c0 = np.random.randint(2**4, 2**8)
+    c1 = np.random.randint(2**6, 2**9)
+    # same draws as gen_test_data.py: slice 0 and b match inputa/inputb_float.txt
+    slices = [np.float32(np.trunc(np.random.rand(F_Ra, F_Ca) * c0))]
+    b = np.float32(np.trunc(np.random.rand(F_Ca, F_Cb) * c1))
+    slices += [np.float32(np.trunc(np.random.rand(F_Ra, F_Ca) * c0)) for _ in range(FG_REPLICAS - 1)]
+
+    for r, a in enumerate(slices):
+        mat2file_tile(a, 4, 2, f"inputa_float_r{r}.txt")
+    mat2file_tile(b, 2, 4, "inputb_float.txt")
+
+    # column maxima per replica; ties keep the lower replica like colmax_merge
+    col_max = np.stack([(a @ b).max(axis=0) for a in slices])
+    best = col_max.argmax(axis=0)
+    with open("ref_replica_float.txt", 'w', encoding="utf-8") as f:
+        for j in range(F_Cb):
+            v = np.format_float_scientific(col_max[best[j], j], min_digits=9)
+            f.write(f'{v} {float(best[j])}\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,37 @@
+# Copyright (C) 2023 Advanced Micro Devices, Inc
+#
+# SPDX-License-Identifier: MIT
+
+import numpy as np
+from write_file import mat2file_tile
+
+# must match system_settings.h
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+STEADY_ITERS = 16
+
+
+def main():
+    """Write STEADY_ITERS query batches back to back for the resident corpus
+    in inputa_float.txt, and the column maxima of every iteration"""
+    np.random.seed(12262023)
+    c0 = np.random.randint(2**4, 2**8)
+    c1 = np.random.randint(2**6, 2**9)
+    # same draws as gen_test_data.py: a and the first batch match inputa/inputb_float.txt
+    a = np.float32(np.trunc(np.random.rand(F_Ra, F_Ca) * c0))
+    batches = [np.float32(np.trunc(np.random.rand(F_Ca, F_Cb) * c1)) for _ in range(STEADY_ITERS)]
+
+    mat2file_tile(a, 4, 2, "inputa_float.txt")
+    mat2file_tile(np.vstack(batches), 2, 4, "steady_b_float.txt")
+
+    with open("ref_steady_float.txt", 'w', encoding="utf-8") as f:
+        for b in batches:
+            col_max = (a @ b).max(axis=0)
+            for j in range(0, F_Cb, 2):
+                v = [np.format_float_scientific(x, min_digits=9) for x in col_max[j:j + 2]]
+                f.write(f'{v[0]} {v[1]}\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -8,9 +8,62 @@
 #include "system_settings.h"
 
 void matmult_float(
-    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_A>& __restrict matA,
+    adf::input_async_buffer<float, adf::extents<NSAMPLES_WINDOW_F_A>>& __restrict matA,
     adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
-    adf::output_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict matColMax);
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict matColMax,
+    int32 rows);
 
+void matmult_float_resident(
+    adf::input_async_buffer<float, adf::extents<NSAMPLES_WINDOW_F_A>>& __restrict matA,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict matColMax,
+    int32 rows);
+
+void colmax_merge_first(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict colMax0,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict colMax1,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_MERGE>& __restrict merged);
+
+template <int REPLICA>
+void colmax_merge(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_MERGE>& __restrict best,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict colMax,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_MERGE>& __restrict merged);
+
+void ivf_coarse_topk(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_A>& __restrict centroids,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict queries,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_IVF_OUT>& __restrict probes);
+
+void matmult_pruned_topk(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_A>& __restrict corpus,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict queries,
+    input_stream<float>* __restrict blockNorm,
+    output_stream<float>* __restrict topk);
+
+void matryoshka_scan(
+    adf::input_async_buffer<float, adf::extents<NSAMPLES_WINDOW_MRL_A>>& __restrict slices,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_MRL_B>& __restrict queries,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_MRL_OUT>& __restrict candidates);
 
+void maxsim_float(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_A>& __restrict doc,
+    input_stream<float>* __restrict query,
+    output_stream<float>* __restrict topk);
 
+void matmult_cascade_first(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_CASC_A>& __restrict matA,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+    output_cascade<accfloat>* __restrict casc_out);
+
+void matmult_cascade_middle(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_CASC_A>& __restrict matA,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+    input_cascade<accfloat>* __restrict casc_in,
+    output_cascade<accfloat>* __restrict casc_out);
+
+void matmult_cascade_last(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_CASC_A>& __restrict matA,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+    input_cascade<accfloat>* __restrict casc_in,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_CASC_OUT>& __restrict matColMax);
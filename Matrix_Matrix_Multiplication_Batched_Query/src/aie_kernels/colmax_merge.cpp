@@ -0,0 +1,43 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+#include <aie_api/aie.hpp>
+#include <aie_api/aie_adf.hpp>
+#include "system_settings.h"
+#include <adf.h>
+
+// Merge stage of the replicated TopGraph. Every replica's matmult_float
+// writes the column maxima of its own corpus slice; the chain folds them
+// into (max, replica) pairs per query column. Ties keep the lower replica,
+// so the result does not depend on the chain order.
+
+// First link: replicas 0 and 1
+void colmax_merge_first(adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict colMax0,
+                        adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict colMax1,
+                        adf::output_buffer_1d<float, NSAMPLES_WINDOW_MERGE>& __restrict merged)
+{
+    const float* __restrict a = colMax0.data();
+    const float* __restrict b = colMax1.data();
+    auto out = aie::begin(merged);
+    for (unsigned j = 0; j < F_Cb; ++j) {
+        const bool second = b[j] > a[j];
+        *out++ = second ? b[j] : a[j];
+        *out++ = second ? 1.0f : 0.0f;
+    }
+}
+
+// Every further link adds replica REPLICA to the running pairs
+template <int REPLICA>
+void colmax_merge(adf::input_buffer_1d<float, NSAMPLES_WINDOW_MERGE>& __restrict best,
+                  adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict colMax,
+                  adf::output_buffer_1d<float, NSAMPLES_WINDOW_MERGE>& __restrict merged)
+{
+    const float* __restrict p = best.data();
+    const float* __restrict c = colMax.data();
+    auto out = aie::begin(merged);
+    for (unsigned j = 0; j < F_Cb; ++j) {
+        const bool take = c[j] > p[2 * j];
+        *out++ = take ? c[j] : p[2 * j];
+        *out++ = take ? (float)REPLICA : p[2 * j + 1];
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+#include <aie_api/aie.hpp>
+#include "system_settings.h"
+#include <adf.h>
+
+// Kernel: IVF coarse pass. Scores F_Cb queries against one block of F_Ra
+// centroids (same C = A x B blocking as matmult_float) and emits, per query
+// column, the IVF_NPROBE best (score, centroid id) pairs of this block.
+// Successive invocations walk the IVF_NLIST / F_Ra centroid blocks; the host
+// merges the per-block lists and streams only the winning posting lists.
+void ivf_coarse_topk(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_A>& __restrict centroids,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict queries,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_IVF_OUT>& __restrict probes)
+{
+    constexpr unsigned M = 4;
+    constexpr unsigned K = 2;
+    constexpr unsigned N = 4;
+    constexpr unsigned P = IVF_NPROBE;
+
+    const unsigned rowA = F_Ra / M;
+    const unsigned colA = F_Ca / K;
+    const unsigned colB = F_Cb / N;
+
+    // Centroid block index, kept across graph iterations
+    static unsigned block = 0;
+    const unsigned base = block * F_Ra;
+
+    const float* __restrict A = centroids.data();
+    const float* __restrict B = queries.data();
+
+    // Per-column sorted (descending) top-P lists
+    alignas(32) float topScore[F_Cb * P];
+    alignas(32) float topId[F_Cb * P];
+    for (unsigned j = 0; j < F_Cb * P; ++j) {
+        topScore[j] = -1e30f;
+        topId[j] = -1.0f;
+    }
+
+    alignas(32) float Cblk[M * N];
+
+    using MMUL = aie::mmul<M, K, N, float, float>;
+
+    for (unsigned z = 0; z < rowA; ++z) {
+        for (unsigned jb = 0; jb < colB; ++jb) {
+            MMUL acc;
+
+            const float *a_ptr = A + (z * colA) * MMUL::size_A;
+            const float *b_ptr = B + jb * MMUL::size_B;
+            acc.mul(aie::load_v<MMUL::size_A>(a_ptr), aie::load_v<MMUL::size_B>(b_ptr));
+
+            for (unsigned i = 1; i < colA; ++i) {
+                a_ptr = A + (z * colA + i) * MMUL::size_A;
+                b_ptr = B + (i * colB + jb) * MMUL::size_B;
+                acc.mac(aie::load_v<MMUL::size_A>(a_ptr), aie::load_v<MMUL::size_B>(b_ptr));
+            }
+
+            aie::store_v(Cblk, acc.template to_vector<float>());
+
+            for (unsigned n = 0; n < N; ++n) {
+                float* score = topScore + (jb * N + n) * P;
+                float* id = topId + (jb * N + n) * P;
+                for (unsigned m = 0; m < M; ++m) {
+                    const float v = Cblk[m * N + n];
+                    if (v <= score[P - 1]) continue;
+                    // insertion into the sorted list, dropping the last entry
+                    unsigned p = P - 1;
+                    while (p > 0 && score[p - 1] < v) {
+                        score[p] = score[p - 1];
+                        id[p] = id[p - 1];
+                        --p;
+                    }
+                    score[p] = v;
+                    id[p] = (float)(base + z * M + m);
+                }
+            }
+        }
+    }
+
+    // Output: for each query column, P pairs of (score, centroid id)
+    auto out = aie::begin(probes);
+    for (unsigned j = 0; j < F_Cb * P; ++j) {
+        *out++ = topScore[j];
+        *out++ = topId[j];
+    }
+
+    block = (block + 1 == IVF_NLIST / F_Ra) ? 0 : block + 1;
+}
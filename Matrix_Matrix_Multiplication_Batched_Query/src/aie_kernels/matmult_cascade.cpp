@@ -0,0 +1,125 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+#include <aie_api/aie.hpp>
+#include <aie_api/aie_adf.hpp>
+#include "system_settings.h"
+#include <adf.h>
+
+// Split-K C = A x B over a cascade chain. Every tile holds the same
+// CASC_ROWS x F_Ca slice shape of A (its own F_Ca dimensions of the corpus
+// rows) and the matching F_Ca x F_Cb slice of B, both in mat2file_tile
+// order. Output blocks are visited in the same (z, jb) order on every tile,
+// so the partial accumulators travel down the cascade in lockstep.
+
+static constexpr unsigned M = 4;
+static constexpr unsigned K = 2;
+static constexpr unsigned N = 4;
+
+using MMUL = aie::mmul<M, K, N, float, float>;
+
+static constexpr unsigned rowA = CASC_ROWS / M;
+static constexpr unsigned colA = F_Ca / K;
+static constexpr unsigned colB = F_Cb / N;
+
+// Adds this tile's K-slice of output block (z, jb) to acc
+[[gnu::always_inline]]
+static inline void mac_slice(MMUL& acc, const float* __restrict A, const float* __restrict B,
+                             unsigned z, unsigned jb)
+{
+    for (unsigned i = 0; i < colA; ++i)
+        chess_prepare_for_pipelining
+    {
+        const float* a_ptr = A + (z * colA + i) * MMUL::size_A;
+        const float* b_ptr = B + (i * colB + jb) * MMUL::size_B;
+        acc.mac(aie::load_v<MMUL::size_A>(a_ptr), aie::load_v<MMUL::size_B>(b_ptr));
+    }
+}
+
+// Kernel: head of the chain, starts every accumulator from zero
+void matmult_cascade_first(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_CASC_A>& __restrict matA,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+    output_cascade<accfloat>* __restrict casc_out)
+{
+    const float* __restrict A = matA.data();
+    const float* __restrict B = matB.data();
+
+    for (unsigned z = 0; z < rowA; ++z) {
+        for (unsigned jb = 0; jb < colB; ++jb) {
+            MMUL acc;
+            acc.mul(aie::load_v<MMUL::size_A>(A + (z * colA) * MMUL::size_A),
+                    aie::load_v<MMUL::size_B>(B + jb * MMUL::size_B));
+            for (unsigned i = 1; i < colA; ++i) {
+                acc.mac(aie::load_v<MMUL::size_A>(A + (z * colA + i) * MMUL::size_A),
+                        aie::load_v<MMUL::size_B>(B + (i * colB + jb) * MMUL::size_B));
+            }
+            writeincr(casc_out, acc.to_accum());
+        }
+    }
+}
+
+// Kernel: interior link, adds its slice and forwards
+void matmult_cascade_middle(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_CASC_A>& __restrict matA,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+    input_cascade<accfloat>* __restrict casc_in,
+    output_cascade<accfloat>* __restrict casc_out)
+{
+    const float* __restrict A = matA.data();
+    const float* __restrict B = matB.data();
+
+    for (unsigned z = 0; z < rowA; ++z) {
+        for (unsigned jb = 0; jb < colB; ++jb) {
+            MMUL acc(readincr_v<MMUL::size_C>(casc_in));
+            mac_slice(acc, A, B, z, jb);
+            writeincr(casc_out, acc.to_accum());
+        }
+    }
+}
+
+// Kernel: tail of the chain, adds its slice and runs the epilogue: the
+// column max and argmax row of C, written as (score, row) pairs
+void matmult_cascade_last(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_CASC_A>& __restrict matA,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+    input_cascade<accfloat>* __restrict casc_in,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_CASC_OUT>& __restrict matColMax)
+{
+    const float* __restrict A = matA.data();
+    const float* __restrict B = matB.data();
+
+    alignas(32) float colMax[F_Cb];
+    alignas(32) float colArg[F_Cb];
+    for (unsigned j = 0; j < F_Cb; ++j) {
+        colMax[j] = -1e30f;
+        colArg[j] = -1.0f;
+    }
+
+    alignas(32) float Cblk[M * N];
+
+    for (unsigned z = 0; z < rowA; ++z) {
+        for (unsigned jb = 0; jb < colB; ++jb) {
+            MMUL acc(readincr_v<MMUL::size_C>(casc_in));
+            mac_slice(acc, A, B, z, jb);
+            aie::store_v(Cblk, acc.template to_vector<float>());
+
+            for (unsigned n = 0; n < N; ++n) {
+                const unsigned gcol = jb * N + n;
+                for (unsigned m = 0; m < M; ++m) {
+                    const float v = Cblk[m * N + n];
+                    if (v > colMax[gcol]) {
+                        colMax[gcol] = v;
+                        colArg[gcol] = (float)(z * M + m);
+                    }
+                }
+            }
+        }
+    }
+
+    auto out = aie::begin(matColMax);
+    for (unsigned j = 0; j < F_Cb; ++j) {
+        *out++ = colMax[j];
+        *out++ = colArg[j];
+    }
+}
@@ -2,13 +2,18 @@
 //
 // SPDX-License-Identifier: MIT
 #include <aie_api/aie.hpp>        // for aie::mmul, load_v, store_v   // for window_get_ptr, window_writeincr
+#include <aie_api/aie_adf.hpp>
 #include "system_settings.h"
 #include <adf.h>
 
-// Kernel: compute column-wise maxima of C = A x B using aie::mmul blocks
-void matmult_float(input_window<float> *__restrict matA,
-                   input_window<float> *__restrict matB,
-                   output_window<float> *__restrict matColMax)
+// Column-wise maxima of C = A x B over the first rows rows of A using
+// aie::mmul blocks; A and B in the 4x2 / 2x4 tile order written by
+// write_file.py::mat2file_tile
+[[gnu::always_inline]]
+static inline void column_max(const float* __restrict A,
+                              const float* __restrict B,
+                              float* __restrict colMax,
+                              unsigned rows = F_Ra)
 {
     // Choose a supported block configuration (M,K,N) for float.
     // You've been using M=4, K=2, N=4 -- keep that if it matches youBayGvbO_r mat layout.
@@ -17,17 +22,10 @@ void matmult_float(input_window<float> *__restrict matA,
     constexpr unsigned N = 4;
 
     // Derived block counts (must divide exactly)
-    const unsigned rowA = F_Ra / M;   // number of M-row blocks
+    const unsigned rowA = rows / M;   // number of M-row blocks
     const unsigned colA = F_Ca / K;   // number of K-column blocks (A's block columns)
     const unsigned colB = F_Cb / N;   // number of N-column blocks (B/C block columns)
 
-    // Get raw pointers to the window data (correct API)
-    const float* __restrict A = reinterpret_cast<const float *>(matA->ptr);
-    const float* __restrict B = reinterpret_cast<const float *>(matB->ptr);
-
-    
-    // Global column maxima (one per final column = F_Cb)
-    alignas(32) float colMax[F_Cb];
     for (unsigned j = 0; j < F_Cb; ++j) colMax[j] = -1e30f;
 
     // Small temporary block buffer to hold one MxN output block
@@ -76,10 +74,117 @@ void matmult_float(input_window<float> *__restrict matA,
             }
         }
     }
+}
+
+// Rows of the A buffer the rows runtime parameter asks for: clamped to
+// [0, F_Ra], then rounded down to a whole M-row block
+static inline unsigned live_rows(int32 rows)
+{
+    if (rows <= 0) return 0;
+    return rows < F_Ra ? (unsigned)rows & ~3u : F_Ra;
+}
+
+// Kernel: compute column-wise maxima of C = A x B using aie::mmul blocks.
+// rows (runtime parameter, multiple of 4, at most F_Ra) is the number of
+// live corpus rows in the A buffer. A is an async buffer: it is released as
+// soon as the MACs are done, so the DMA of the next corpus block overlaps
+// the output epilogue instead of waiting for the kernel to return.
+void matmult_float(adf::input_async_buffer<float, adf::extents<NSAMPLES_WINDOW_F_A>>& __restrict matA,
+                   adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+                   adf::output_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict matColMax,
+                   int32 rows)
+{
+    matA.acquire();
+    const float* __restrict A = matA.data();
+    const float* __restrict B = matB.data();
 
-    // Write out all column maxima to output window (one float per column)
+    // Global column maxima (one per final column = F_Cb)
+    alignas(32) float colMax[F_Cb];
+    column_max(A, B, colMax, live_rows(rows));
+    matA.release();
+
+    // Write out all column maxima to the output buffer (one float per column)
+    auto out = aie::begin(matColMax);
     for (unsigned j = 0; j < F_Cb; ++j) {
-        window_writeincr(matColMax, colMax[j]);
+        *out++ = colMax[j];
+    }
+}
+
+// Steady-state form of matmult_float (STEADY_STATE mode). The corpus block
+// in matA is acquired on the first iteration and never released, so it
+// stays resident in the tile while query batches stream through matB's
+// ping-pong buffers, one batch per graph iteration.
+void matmult_float_resident(adf::input_async_buffer<float, adf::extents<NSAMPLES_WINDOW_F_A>>& __restrict matA,
+                            adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict matB,
+                            adf::output_buffer_1d<float, NSAMPLES_WINDOW_F_C>& __restrict matColMax,
+                            int32 rows)
+{
+    static bool resident = false;
+    if (!resident) {
+        matA.acquire();
+        resident = true;
+    }
+
+    alignas(32) float colMax[F_Cb];
+    column_max(matA.data(), matB.data(), colMax, live_rows(rows));
+
+    auto out = aie::begin(matColMax);
+    for (unsigned j = 0; j < F_Cb; ++j) {
+        *out++ = colMax[j];
+    }
+}
+
+// Query token embeddings of the current MaxSim query, B tile order
+alignas(32) static float maxsim_query[NSAMPLES_WINDOW_F_B];
+
+// Kernel: late-interaction (ColBERT) MaxSim. A is one document's F_Ra token
+// embeddings, the query's F_Cb token embeddings arrive once per query on a
+// stream. The per-query-token max over document tokens is column_max; their
+// sum is the document score. MAXSIM_DOCS documents stream through per query
+// and the MAXSIM_TOPK best (score, document) pairs are emitted at the end.
+// Documents shorter than F_Ra tokens are padded by repeating a real token.
+void maxsim_float(adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_A>& __restrict doc,
+                  input_stream<float> *__restrict query,
+                  output_stream<float> *__restrict topk)
+{
+    static unsigned docId = 0;
+    static float topScore[MAXSIM_TOPK];
+    static float topDoc[MAXSIM_TOPK];
+
+    if (docId == 0) {
+        for (unsigned i = 0; i < NSAMPLES_WINDOW_F_B; i += 4)
+            aie::store_v(maxsim_query + i, readincr_v<4>(query));
+        for (unsigned k = 0; k < MAXSIM_TOPK; ++k) {
+            topScore[k] = -1e30f;
+            topDoc[k] = -1.0f;
+        }
+    }
+
+    alignas(32) float colMax[F_Cb];
+    column_max(doc.data(), maxsim_query, colMax);
+
+    aie::vector<float, 8> partial = aie::zeros<float, 8>();
+    for (unsigned j = 0; j < F_Cb; j += 8)
+        partial = aie::add(partial, aie::load_v<8>(colMax + j));
+    const float score = aie::reduce_add(partial);
+
+    if (score > topScore[MAXSIM_TOPK - 1]) {
+        unsigned p = MAXSIM_TOPK - 1;
+        while (p > 0 && topScore[p - 1] < score) {
+            topScore[p] = topScore[p - 1];
+            topDoc[p] = topDoc[p - 1];
+            --p;
+        }
+        topScore[p] = score;
+        topDoc[p] = (float)docId;
+    }
+
+    if (++docId == MAXSIM_DOCS) {
+        for (unsigned k = 0; k < MAXSIM_TOPK; ++k) {
+            writeincr(topk, topScore[k]);
+            writeincr(topk, topDoc[k]);
+        }
+        docId = 0;
     }
 }
 
@@ -221,7 +326,7 @@ void matmult_float(input_window<float> *__restrict matA,
 //     constexpr unsigned N = 4;
 
 //     // Derived block counts (must exactly divide the full sizes)
-//     const unsigned rowA = F_Ra / M;   // number of M-row blocks
+//     const unsigned rowA = rows / M;   // number of M-row blocks
 //     const unsigned colA = F_Ca / K;   // number of K-column blocks (A's block columns)
 //     const unsigned colB = F_Cb / N;   // number of N-column blocks (B/C block columns)
 
@@ -0,0 +1,81 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+#include <aie_api/aie.hpp>
+#include <aie_api/aie_adf.hpp>
+#include "system_settings.h"
+#include "matmult_generic.h"
+#include <adf.h>
+
+// Scores of the current block, MxN blocks as mmul_blocked stores them
+alignas(32) static float mrl_scores[MRL_ROWS * F_Cb];
+
+// Kernel: first pass of the Matryoshka two-pass search. A is a block of
+// MRL_ROWS corpus rows holding only their leading MRL_DIM dimensions (the
+// host stores that slice as its own contiguous array, so it streams at full
+// rate), B the query batch cut to the same dimensions. The block is scored
+// with mmul_blocked and, per query column, the MRL_TOPR best (score, row)
+// pairs of the block are written. Successive invocations walk the corpus;
+// the host merges the per-block lists into the top-R candidates and
+// rescores them at full dimension.
+void matryoshka_scan(
+    adf::input_async_buffer<float, adf::extents<NSAMPLES_WINDOW_MRL_A>>& __restrict slices,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_MRL_B>& __restrict queries,
+    adf::output_buffer_1d<float, NSAMPLES_WINDOW_MRL_OUT>& __restrict candidates)
+{
+    constexpr unsigned M = 4;
+    constexpr unsigned K = 2;
+    constexpr unsigned N = 4;
+    constexpr unsigned P = MRL_TOPR;
+
+    const unsigned rowA = MRL_ROWS / M;
+    const unsigned colB = F_Cb / N;
+
+    // Corpus block index, kept across graph iterations
+    static unsigned block = 0;
+    const unsigned base = block * MRL_ROWS;
+
+    // the slices are only needed by the MACs; releasing them before the
+    // top-R epilogue lets the next block's DMA start early
+    slices.acquire();
+    mmul_blocked<M, K, N, float>(rowA, MRL_DIM / K, colB, slices.data(), queries.data(), mrl_scores);
+    slices.release();
+
+    alignas(32) float topScore[F_Cb * P];
+    alignas(32) float topId[F_Cb * P];
+    for (unsigned j = 0; j < F_Cb * P; ++j) {
+        topScore[j] = -1e30f;
+        topId[j] = -1.0f;
+    }
+
+    for (unsigned z = 0; z < rowA; ++z) {
+        for (unsigned jb = 0; jb < colB; ++jb) {
+            const float* Cblk = mrl_scores + (z * colB + jb) * M * N;
+            for (unsigned n = 0; n < N; ++n) {
+                float* score = topScore + (jb * N + n) * P;
+                float* id = topId + (jb * N + n) * P;
+                for (unsigned m = 0; m < M; ++m) {
+                    const float v = Cblk[m * N + n];
+                    if (v <= score[P - 1]) continue;
+                    unsigned p = P - 1;
+                    while (p > 0 && score[p - 1] < v) {
+                        score[p] = score[p - 1];
+                        id[p] = id[p - 1];
+                        --p;
+                    }
+                    score[p] = v;
+                    id[p] = (float)(base + z * M + m);
+                }
+            }
+        }
+    }
+
+    // Output: for each query column, P pairs of (score, row)
+    auto out = aie::begin(candidates);
+    for (unsigned j = 0; j < F_Cb * P; ++j) {
+        *out++ = topScore[j];
+        *out++ = topId[j];
+    }
+
+    block = (block + 1 == MRL_BLOCKS) ? 0 : block + 1;
+}
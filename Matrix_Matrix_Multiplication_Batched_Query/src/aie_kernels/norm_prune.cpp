@@ -0,0 +1,127 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+#include <aie_api/aie.hpp>
+#include <aie_api/aie_adf.hpp>
+#include "system_settings.h"
+#include <adf.h>
+
+// Kernel: exact top-K scan with norm-bound block pruning. Every invocation
+// scores one block of F_Ra corpus rows against the F_Cb queries (same
+// blocking as matmult_float); PRUNE_BLOCKS invocations make one scan. The
+// host sends the largest row norm of the block on blockNorm. By
+// Cauchy-Schwarz no row of the block can score above |q| * maxNorm, so a
+// group of N query columns whose bounds all fail to beat their current K-th
+// score skips the block without a single MAC. Bounds are compared squared,
+// no square root on the tile. With the corpus sorted by descending norm the
+// K-th scores rise fast and the tail blocks drop out.
+// At the end of the scan the kernel writes, per query, PRUNE_TOPK
+// (score, row) pairs and then the number of skipped (block, column group)
+// pairs.
+void matmult_pruned_topk(
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_A>& __restrict corpus,
+    adf::input_buffer_1d<float, NSAMPLES_WINDOW_F_B>& __restrict queries,
+    input_stream<float>* __restrict blockNorm,
+    output_stream<float>* __restrict topk)
+{
+    constexpr unsigned M = 4;
+    constexpr unsigned K = 2;
+    constexpr unsigned N = 4;
+    constexpr unsigned P = PRUNE_TOPK;
+
+    const unsigned rowA = F_Ra / M;
+    const unsigned colA = F_Ca / K;
+    const unsigned colB = F_Cb / N;
+
+    // Scan state, kept across graph iterations
+    static unsigned block = 0;
+    static unsigned skipped = 0;
+    static float qNorm2[F_Cb];
+    static float topScore[F_Cb * P];
+    static float topId[F_Cb * P];
+
+    const float* __restrict A = corpus.data();
+    const float* __restrict B = queries.data();
+
+    if (block == 0) {
+        skipped = 0;
+        for (unsigned j = 0; j < F_Cb * P; ++j) {
+            topScore[j] = -1e30f;
+            topId[j] = -1.0f;
+        }
+        // squared query norms; B holds K x N blocks, column jb * N + n
+        for (unsigned j = 0; j < F_Cb; ++j) qNorm2[j] = 0.0f;
+        for (unsigned i = 0; i < colA; ++i)
+            for (unsigned jb = 0; jb < colB; ++jb)
+                for (unsigned k = 0; k < K; ++k)
+                    for (unsigned n = 0; n < N; ++n) {
+                        const float v = B[(i * colB + jb) * K * N + k * N + n];
+                        qNorm2[jb * N + n] += v * v;
+                    }
+    }
+
+    const float maxNorm = readincr(blockNorm);
+    const float maxNorm2 = maxNorm * maxNorm;
+    const unsigned base = block * F_Ra;
+
+    // Column groups that can still gain from this block. K-th scores only
+    // rise while the block is scored, so deciding up front is safe.
+    bool live[F_Cb / N];
+    for (unsigned jb = 0; jb < colB; ++jb) {
+        live[jb] = false;
+        for (unsigned n = 0; n < N; ++n) {
+            const float kth = topScore[(jb * N + n) * P + P - 1];
+            if (kth < 0.0f || qNorm2[jb * N + n] * maxNorm2 > kth * kth) live[jb] = true;
+        }
+        if (!live[jb]) ++skipped;
+    }
+
+    alignas(32) float Cblk[M * N];
+
+    using MMUL = aie::mmul<M, K, N, float, float>;
+
+    for (unsigned jb = 0; jb < colB; ++jb) {
+        if (!live[jb]) continue;
+        for (unsigned z = 0; z < rowA; ++z) {
+            MMUL acc;
+
+            const float *a_ptr = A + (z * colA) * MMUL::size_A;
+            const float *b_ptr = B + jb * MMUL::size_B;
+            acc.mul(aie::load_v<MMUL::size_A>(a_ptr), aie::load_v<MMUL::size_B>(b_ptr));
+
+            for (unsigned i = 1; i < colA; ++i) {
+                a_ptr = A + (z * colA + i) * MMUL::size_A;
+                b_ptr = B + (i * colB + jb) * MMUL::size_B;
+                acc.mac(aie::load_v<MMUL::size_A>(a_ptr), aie::load_v<MMUL::size_B>(b_ptr));
+            }
+
+            aie::store_v(Cblk, acc.template to_vector<float>());
+
+            for (unsigned n = 0; n < N; ++n) {
+                float* score = topScore + (jb * N + n) * P;
+                float* id = topId + (jb * N + n) * P;
+                for (unsigned m = 0; m < M; ++m) {
+                    const float v = Cblk[m * N + n];
+                    if (v <= score[P - 1]) continue;
+                    unsigned p = P - 1;
+                    while (p > 0 && score[p - 1] < v) {
+                        score[p] = score[p - 1];
+                        id[p] = id[p - 1];
+                        --p;
+                    }
+                    score[p] = v;
+                    id[p] = (float)(base + z * M + m);
+                }
+            }
+        }
+    }
+
+    if (++block == PRUNE_BLOCKS) {
+        for (unsigned j = 0; j < F_Cb * P; ++j) {
+            writeincr(topk, topScore[j]);
+            writeincr(topk, topId[j]);
+        }
+        writeincr(topk, (float)skipped);
+        block = 0;
+    }
+}
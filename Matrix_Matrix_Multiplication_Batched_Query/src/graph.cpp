@@ -4,13 +4,43 @@
 
 #include "graph.h"
 
-TopGraph mult_graph;
+#ifdef CASCADE
+CascadeTopGraph mult_graph;
+#elif defined(NORM_PRUNE)
+PruneTopGraph mult_graph;
+#else
+TopGraph<> mult_graph;
+#endif
 
 #if defined(__AIESIM__) || defined(__X86SIM__)
    int main(int argc, char ** argv)
    {
       mult_graph.init();
+#ifdef IVF_COARSE
+      // one iteration per centroid block; ivf_queries_float.txt repeats the queries
+      mult_graph.run(IVF_NLIST / F_Ra);
+#elif defined(MAXSIM)
+      // one iteration per document; the query tokens are read on the first
+      mult_graph.run(MAXSIM_DOCS);
+#elif defined(CASCADE)
+      mult_graph.run(1);
+#elif defined(NORM_PRUNE)
+      // one iteration per corpus block; prune_b_float.txt repeats the queries
+      mult_graph.run(PRUNE_BLOCKS);
+#elif defined(MATRYOSHKA)
+      // one iteration per corpus block; mrl_queries_float.txt repeats the queries
+      mult_graph.run(MRL_BLOCKS);
+#elif defined(STEADY_STATE)
+      // corpus loaded once, then one query batch per iteration; simulation
+      // only, as this project links no PL movers or host to feed run(-1)
+      for (int r = 0; r < FG_REPLICAS; ++r)
+         mult_graph.update(mult_graph.FG[r].rows, F_Ra);
+      mult_graph.run(STEADY_ITERS);
+#else
+      for (int r = 0; r < FG_REPLICAS; ++r)
+         mult_graph.update(mult_graph.FG[r].rows, F_Ra);
       mult_graph.run(1);
+#endif
       mult_graph.end();
 
       return 0;
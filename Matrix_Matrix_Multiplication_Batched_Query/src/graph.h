@@ -156,6 +156,14 @@
 #include "system_settings.h"
 
 #include <adf.h>
+#include <string>
+
+// #define IVF_COARSE
+// #define MAXSIM
+// #define CASCADE
+// #define NORM_PRUNE
+// #define MATRYOSHKA
+// #define STEADY_STATE
 
 template<int R = 100>
 class MatMultFloatGraph : public adf::graph {
@@ -165,52 +173,377 @@ private:
 public:
   adf::port<adf::input> ina, inb;
   adf::port<adf::output> outc;
+  // runtime parameter: live corpus rows in the A window (<= F_Ra)
+  adf::port<adf::input> rows;
 
   MatMultFloatGraph() {
     using namespace adf;
     k = kernel::create(matmult_float);
 
-    connect<window<NSAMPLES_WINDOW_F_A * sizeof(float)>> float_ina(ina, k.in[0]);
-    connect<window<NSAMPLES_WINDOW_F_B * sizeof(float)>> float_inb(inb, k.in[1]);
-    connect<window<NSAMPLES_WINDOW_F_C * sizeof(float)>> float_outc(k.out[0], outc);
+    connect(ina, k.in[0]);
+    connect(inb, k.in[1]);
+    connect(k.out[0], outc);
+    connect<parameter>(rows, async(k.in[2]));
     source(k) = "aie_kernels/matmult_float.cpp";
     runtime<ratio>(k) = float(R / 100.0);
   }
 };
 
+// Steady state: A is loaded once into a single buffer and kept, B stays
+// ping-pong so the next query batch lands while the current one is scored
+template<int R = 100>
+class ResidentFloatGraph : public adf::graph {
+private:
+  adf::kernel k;
+
+public:
+  adf::port<adf::input> ina, inb;
+  adf::port<adf::output> outc;
+  // runtime parameter: live corpus rows in the A buffer (<= F_Ra)
+  adf::port<adf::input> rows;
+
+  ResidentFloatGraph() {
+    using namespace adf;
+    k = kernel::create(matmult_float_resident);
+
+    connect(ina, k.in[0]);
+    connect(inb, k.in[1]);
+    connect(k.out[0], outc);
+    connect<parameter>(rows, async(k.in[2]));
+    single_buffer(k.in[0]);
+    source(k) = "aie_kernels/matmult_float.cpp";
+    runtime<ratio>(k) = float(R / 100.0);
+  }
+};
+
+// IVF coarse pass: A carries centroid blocks, B the query batch
+template<int R = 100>
+class IvfCoarseGraph : public adf::graph {
+private:
+  adf::kernel k;
+
+public:
+  adf::port<adf::input> ina, inb;
+  adf::port<adf::output> outc;
+
+  IvfCoarseGraph() {
+    using namespace adf;
+    k = kernel::create(ivf_coarse_topk);
+
+    connect(ina, k.in[0]);
+    connect(inb, k.in[1]);
+    connect(k.out[0], outc);
+    source(k) = "aie_kernels/ivf_coarse.cpp";
+    runtime<ratio>(k) = float(R / 100.0);
+  }
+};
+
+// Norm-bound pruning: A carries one corpus block per iteration, B the query
+// batch, norms the largest row norm of each block; outc gets the top-K
+// lists once per PRUNE_BLOCKS iterations
+template<int R = 100>
+class NormPruneGraph : public adf::graph {
+private:
+  adf::kernel k;
+
+public:
+  adf::port<adf::input> ina, inb, norms;
+  adf::port<adf::output> outc;
+
+  NormPruneGraph() {
+    using namespace adf;
+    k = kernel::create(matmult_pruned_topk);
+
+    connect(ina, k.in[0]);
+    connect(inb, k.in[1]);
+    connect<stream>(norms, k.in[2]);
+    connect<stream>(k.out[0], outc);
+    source(k) = "aie_kernels/norm_prune.cpp";
+    runtime<ratio>(k) = float(R / 100.0);
+  }
+};
+
+// Matryoshka first pass: A carries leading-dimension slices of one corpus
+// block per iteration, B the query batch cut to the same dimensions
+template<int R = 100>
+class MatryoshkaGraph : public adf::graph {
+private:
+  adf::kernel k;
+
+public:
+  adf::port<adf::input> ina, inb;
+  adf::port<adf::output> outc;
+
+  MatryoshkaGraph() {
+    using namespace adf;
+    k = kernel::create(matryoshka_scan);
+
+    connect(ina, k.in[0]);
+    connect(inb, k.in[1]);
+    connect(k.out[0], outc);
+    source(k) = "aie_kernels/matryoshka.cpp";
+    runtime<ratio>(k) = float(R / 100.0);
+  }
+};
+
+// MaxSim: A carries one document per iteration, B the query tokens once
+// per MAXSIM_DOCS iterations as a stream; outc is the (score, doc) top-K
+template<int R = 100>
+class MaxSimFloatGraph : public adf::graph {
+private:
+  adf::kernel k;
+
+public:
+  adf::port<adf::input> ina, inb;
+  adf::port<adf::output> outc;
+
+  MaxSimFloatGraph() {
+    using namespace adf;
+    k = kernel::create(maxsim_float);
+
+    connect(ina, k.in[0]);
+    connect<stream>(inb, k.in[1]);
+    connect<stream>(k.out[0], outc);
+    source(k) = "aie_kernels/matmult_float.cpp";
+    runtime<ratio>(k) = float(R / 100.0);
+  }
+};
+
+// Split-K over LEN tiles linked by the cascade bus: ina[i] / inb[i] carry
+// the i-th F_Ca-wide slice of the corpus rows and of the queries, partial
+// sums flow down the chain and only the last tile writes (max, argmax)
+template<int LEN = CASC_LEN, int R = 100>
+class MatMultCascadeGraph : public adf::graph {
+private:
+  adf::kernel k[LEN];
+
+public:
+  adf::port<adf::input> ina[LEN], inb[LEN];
+  adf::port<adf::output> outc;
+
+  MatMultCascadeGraph() {
+    using namespace adf;
+    static_assert(LEN >= 2, "a cascade chain needs a first and a last tile");
+
+    k[0] = kernel::create(matmult_cascade_first);
+    for (int i = 1; i < LEN - 1; ++i) {
+      k[i] = kernel::create(matmult_cascade_middle);
+    }
+    k[LEN - 1] = kernel::create(matmult_cascade_last);
+
+    for (int i = 0; i < LEN; ++i) {
+      connect(ina[i], k[i].in[0]);
+      connect(inb[i], k[i].in[1]);
+      source(k[i]) = "aie_kernels/matmult_cascade.cpp";
+      runtime<ratio>(k[i]) = float(R / 100.0);
+    }
+    for (int i = 0; i < LEN - 1; ++i) {
+      connect<cascade>(k[i].out[0], k[i + 1].in[2]);
+    }
+    connect(k[LEN - 1].out[0], outc);
+  }
+};
+
+// Merge chain behind the replicated MatMultFloatGraph: in[r] takes the
+// column maxima of replica r, out the (max, replica) pair of every query
+template<int I, int REPLICAS>
+struct ColMaxMergeLinks {
+  // link I - 1 of the chain folds in replica I
+  static void create(adf::kernel* k) {
+    k[I - 1] = adf::kernel::create(colmax_merge<I>);
+    ColMaxMergeLinks<I + 1, REPLICAS>::create(k);
+  }
+};
+
+template<int REPLICAS>
+struct ColMaxMergeLinks<REPLICAS, REPLICAS> {
+  static void create(adf::kernel*) {}
+};
+
+template<int REPLICAS, int R = 100>
+class ColMaxMergeGraph : public adf::graph {
+private:
+  adf::kernel k[REPLICAS - 1];
+
+public:
+  adf::port<adf::input> in[REPLICAS];
+  adf::port<adf::output> out;
+
+  ColMaxMergeGraph() {
+    using namespace adf;
+    k[0] = kernel::create(colmax_merge_first);
+    ColMaxMergeLinks<2, REPLICAS>::create(k);
+
+    connect(in[0], k[0].in[0]);
+    connect(in[1], k[0].in[1]);
+    for (int i = 2; i < REPLICAS; ++i) {
+      connect(k[i - 2].out[0], k[i - 1].in[0]);
+      connect(in[i], k[i - 1].in[1]);
+    }
+    connect(k[REPLICAS - 2].out[0], out);
+
+    for (int i = 0; i < REPLICAS - 1; ++i) {
+      source(k[i]) = "aie_kernels/colmax_merge.cpp";
+      runtime<ratio>(k[i]) = float(R / 100.0);
+    }
+  }
+
+  template<class G>
+  void link(G* replicas, adf::output_plio& o) {
+    for (int i = 0; i < REPLICAS; ++i) {
+      adf::connect(replicas[i].outc, in[i]);
+    }
+    adf::connect(out, o.in[0]);
+  }
+};
+
+// A single replica needs no merge; its column maxima go straight out
+template<int R>
+class ColMaxMergeGraph<1, R> : public adf::graph {
+public:
+  template<class G>
+  void link(G* replicas, adf::output_plio& o) {
+    adf::connect(replicas[0].outc, o.in[0]);
+  }
+};
+
+// REPLICAS copies of the mode's graph. Replica r scans its own corpus slice
+// from in[r] (DataInFP_A<r>, <a file>_r<r>.txt once there is more than one)
+// and all replicas share the query batch broadcast from in[REPLICAS]. Only
+// the column max graphs (plain and steady state) are replicated; their
+// outputs meet in ColMaxMergeGraph.
+template<int REPLICAS = FG_REPLICAS>
 class TopGraph : public adf::graph {
 public:
-  static constexpr unsigned num_input = 2, num_output = 1;
+  static constexpr unsigned num_input = REPLICAS + 1, num_output = 1;
   std::array<adf::input_plio, num_input> in;
   std::array<adf::output_plio, num_output> out;
 
-  MatMultFloatGraph<100> FG;
+#ifdef IVF_COARSE
+  IvfCoarseGraph<100> FG[REPLICAS];
+
+  TopGraph()
+      : TopGraph({"DataInFP_A", "DataInFP_B"},
+                 {"data/ivf_centroids_float.txt", "data/ivf_queries_float.txt"},
+                 {"DataOutFP"},
+                 {"ivf_probe_output.txt"}) {}
+#elif defined(MAXSIM)
+  MaxSimFloatGraph<100> FG[REPLICAS];
+
+  TopGraph()
+      : TopGraph({"DataInFP_A", "DataInFP_B"},
+                 {"data/maxsim_docs_float.txt", "data/maxsim_query_float.txt"},
+                 {"DataOutFP"},
+                 {"maxsim_output.txt"}) {}
+#elif defined(MATRYOSHKA)
+  MatryoshkaGraph<100> FG[REPLICAS];
+
+  TopGraph()
+      : TopGraph({"DataInFP_A", "DataInFP_B"},
+                 {"data/mrl_slices_float.txt", "data/mrl_queries_float.txt"},
+                 {"DataOutFP"},
+                 {"mrl_output.txt"}) {}
+#elif defined(STEADY_STATE)
+#define TOPGRAPH_MERGES
+  ResidentFloatGraph<100> FG[REPLICAS];
+  ColMaxMergeGraph<REPLICAS> merge;
+
+  TopGraph()
+      : TopGraph({"DataInFP_A", "DataInFP_B"},
+                 {"data/inputa_float.txt", "data/steady_b_float.txt"},
+                 {"DataOutFP"},
+                 {"steady_output.txt"}) {}
+#else
+#define TOPGRAPH_MERGES
+  MatMultFloatGraph<100> FG[REPLICAS];
+  ColMaxMergeGraph<REPLICAS> merge;
 
   TopGraph()
       : TopGraph({"DataInFP_A", "DataInFP_B"},
                  {"data/inputa_float.txt", "data/inputb_float.txt"},
                  {"DataOutFP"},
-                 {"float_output.txt"}) {}
+                 {REPLICAS > 1 ? "replica_output.txt" : "float_output.txt"}) {}
+#endif
 
 private:
-  TopGraph(const std::array<const char*, num_input>& input_names,
-           const std::array<const char*, num_input>& input_files,
+  TopGraph(const std::array<const char*, 2>& input_names,
+           const std::array<const char*, 2>& input_files,
            const std::array<const char*, num_output>& output_names,
            const std::array<const char*, num_output>& output_files) {
     using namespace adf;
-
-    for (unsigned i = 0; i < in.size(); ++i) {
-      in[i] = input_plio::create(input_names[i], plio_64_bits, input_files[i]);
+#ifndef TOPGRAPH_MERGES
+    static_assert(REPLICAS == 1, "only the column max graph is replicated");
+#endif
+
+    for (int r = 0; r < REPLICAS; ++r) {
+      std::string name = input_names[0];
+      std::string file = input_files[0];
+      if (REPLICAS > 1) {
+        name += std::to_string(r);
+        file.insert(file.rfind('.'), "_r" + std::to_string(r));
+      }
+      in[r] = input_plio::create(name, plio_64_bits, file);
+      connect(in[r].out[0], FG[r].ina);
+    }
+    in[REPLICAS] = input_plio::create(input_names[1], plio_64_bits, input_files[1]);
+    for (int r = 0; r < REPLICAS; ++r) {
+      connect(in[REPLICAS].out[0], FG[r].inb);
     }
 
     for (unsigned i = 0; i < out.size(); ++i) {
       out[i] = output_plio::create(output_names[i], plio_64_bits, output_files[i]);
     }
+#ifdef TOPGRAPH_MERGES
+    merge.link(FG, out[0]);
+#else
+    connect(FG[0].outc, out[0].in[0]);
+#endif
+  }
+};
+
+// CASCADE mode: one A and one B PLIO per cascade tile
+class CascadeTopGraph : public adf::graph {
+public:
+  std::array<adf::input_plio, CASC_LEN> ina, inb;
+  adf::output_plio out;
+
+  MatMultCascadeGraph<CASC_LEN, 100> FG;
+
+  CascadeTopGraph() {
+    using namespace adf;
+
+    for (unsigned i = 0; i < CASC_LEN; ++i) {
+      const std::string n = std::to_string(i);
+      ina[i] = input_plio::create("CascInA_" + n, plio_64_bits, "data/casc_a_" + n + ".txt");
+      inb[i] = input_plio::create("CascInB_" + n, plio_64_bits, "data/casc_b_" + n + ".txt");
+      connect(ina[i].out[0], FG.ina[i]);
+      connect(inb[i].out[0], FG.inb[i]);
+    }
+
+    out = output_plio::create("DataOutFP", plio_64_bits, "casc_output.txt");
+    connect(FG.outc, out.in[0]);
+  }
+};
+
+// NORM_PRUNE mode: corpus blocks, query batch and block norms on their own PLIOs
+class PruneTopGraph : public adf::graph {
+public:
+  adf::input_plio ina, inb, norms;
+  adf::output_plio out;
+
+  NormPruneGraph<100> FG;
+
+  PruneTopGraph() {
+    using namespace adf;
+
+    ina = input_plio::create("DataInFP_A", plio_64_bits, "data/prune_a_float.txt");
+    inb = input_plio::create("DataInFP_B", plio_64_bits, "data/prune_b_float.txt");
+    norms = input_plio::create("DataInNorm", plio_32_bits, "data/prune_norms_float.txt");
+    out = output_plio::create("DataOutFP", plio_64_bits, "prune_output.txt");
 
-    connect<> netlist[] = {
-        {in[0].out[0], FG.ina},
-        {in[1].out[0], FG.inb},
-        {FG.outc, out[0].in[0]},
-    };
+    connect(ina.out[0], FG.ina);
+    connect(inb.out[0], FG.inb);
+    connect(norms.out[0], FG.norms);
+    connect(FG.outc, out.in[0]);
   }
 };
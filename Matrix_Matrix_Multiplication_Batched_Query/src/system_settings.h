@@ -27,3 +27,54 @@ Dimensions
 #define NSAMPLES_WINDOW_F_A (F_Ra*F_Ca)
 #define NSAMPLES_WINDOW_F_B (F_Rb*F_Cb)
 #define NSAMPLES_WINDOW_F_C (F_Cc)
+
+// Replicated TopGraph: FG_REPLICAS copies of matmult_float, each scanning
+// its own corpus slice against the broadcast query batch. A merge chain
+// folds their column maxima into (max, replica) pairs.
+#define FG_REPLICAS 1
+#define NSAMPLES_WINDOW_MERGE (F_Cb*2)
+
+// Steady state: the corpus block stays resident and STEADY_ITERS query
+// batches are scored back to back, one per graph iteration
+#define STEADY_ITERS 16
+
+// IVF coarse quantizer: A holds F_Ra centroids per window, IVF_NLIST in total.
+// Each query column keeps its IVF_NPROBE best (score, centroid id) pairs.
+#define IVF_NLIST 1024
+#define IVF_NPROBE 8
+#define NSAMPLES_WINDOW_IVF_OUT (F_Cb*IVF_NPROBE*2)
+
+// MaxSim (late interaction): A holds one document's F_Ra token embeddings,
+// the query's F_Cb tokens are streamed once per MAXSIM_DOCS documents.
+#define MAXSIM_DOCS 64
+#define MAXSIM_TOPK 8
+
+// Cascade split-K: CASC_LEN tiles in a cascade chain, each holding an
+// F_Ca-wide slice of CASC_ROWS corpus rows and of the F_Cb queries.
+#define CASC_LEN 24
+#define CASC_ROWS 64
+#define CASC_DIM (CASC_LEN*F_Ca)
+#define NSAMPLES_WINDOW_CASC_A (CASC_ROWS*F_Ca)
+#define NSAMPLES_WINDOW_CASC_OUT (F_Cb*2)
+
+// Norm-bound pruning: one scan walks PRUNE_BLOCKS blocks of F_Ra corpus rows
+// (sorted by descending norm on the host) and keeps PRUNE_TOPK (score, row)
+// pairs per query
+#define PRUNE_BLOCKS 16
+#define PRUNE_TOPK 8
+
+// Matryoshka first pass: A holds the leading MRL_DIM of MRL_FULL_DIM
+// dimensions of MRL_ROWS corpus rows, MRL_BLOCKS blocks per corpus pass.
+// Each query column keeps MRL_TOPR (score, row) pairs per block; the full-dim
+// rerank of the merged candidates runs on the host. A graph run therefore
+// yields MRL_BLOCKS * MRL_TOPR = 256 candidates per query and the host's
+// top-R is capped at MRL_TOPR / MRL_ROWS of the corpus; larger corpora take
+// one run per MRL_BLOCKS blocks, rows offset by the host.
+#define MRL_DIM 64
+#define MRL_FULL_DIM 768
+#define MRL_ROWS 64
+#define MRL_BLOCKS 16
+#define MRL_TOPR 16
+#define NSAMPLES_WINDOW_MRL_A (MRL_ROWS*MRL_DIM)
+#define NSAMPLES_WINDOW_MRL_B (MRL_DIM*F_Cb)
+#define NSAMPLES_WINDOW_MRL_OUT (F_Cb*MRL_TOPR*2)
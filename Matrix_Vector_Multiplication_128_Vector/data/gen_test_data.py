@@ -1,5 +1,25 @@
 import numpy as np
 
+# must match VADD_MAX_ROWS / VADD_MAX_K in src/kernels.hpp
+BLOCK_ROWS = 256
+MAX_K = 8
+BATCH = 4       # VADD_BATCH, queries per aie_vadd_window_batched invocation
+
+# Attribute words: bit 31 marks a real corpus vector, bits 0..ATTR_BITS-1 are
+# random tags. A vector passes when it carries every bit of the query mask;
+# must match the mask update in src/graph.cpp
+ATTR_VALID = 1 << 31
+ATTR_BITS = 4
+QUERY_MASK = ATTR_VALID | 0x5
+
+
+def block_topk(dots, attrs, k=MAX_K, min_score=-1.0, mask=QUERY_MASK):
+    """(score, index) pairs the kernel writes for one block, (-1, -1) padded"""
+    order = [i for i in np.argsort(-dots, kind='stable') if (attrs[i] & mask) == mask]
+    pairs = [(dots[i], i) for i in order[:k] if dots[i] > min_score]
+    return pairs + [(-1.0, -1)] * (MAX_K - len(pairs))
+
+
 def write_file_one_per_line(file: str, data):
     """
     Writes all floats to a file, one element per line.
@@ -26,6 +46,8 @@ def main():
     targets = np.random.randn(NUM_VECTORS, VECTOR_SIZE).astype(np.float32)
     targets = np.array([v / np.linalg.norm(v) for v in targets], dtype=np.float32)
 
+    attrs = ATTR_VALID | np.random.randint(0, 1 << ATTR_BITS, NUM_VECTORS)
+
     # Compute dot products
     dot_products = targets @ query
 
@@ -39,11 +61,29 @@ def main():
     # Write query and targets to files
     write_file_one_per_line('input0.txt', query)
     write_file_one_per_line('input1.txt', targets)
+    with open('input2.txt', 'w') as f:
+        for a in attrs:
+            f.write(f"{int(a) - (1 << 32) if a & ATTR_VALID else int(a)}\n")  # as int32
 
-    # Write expected max dot product to golden file
+    # Expected top-K of every block, block-local indices
     with open('golden.txt', 'w') as f:
-        f.write(f"{max_dot:.9e}\n")
-        f.write(f"{max_index:.9e}\n")  # scientific notation
+        for b in range(0, NUM_VECTORS, BLOCK_ROWS):
+            for score, index in block_topk(dot_products[b:b + BLOCK_ROWS], attrs[b:b + BLOCK_ROWS]):
+                f.write(f"{score:.9e}\n")
+                f.write(f"{float(index):.9e}\n")  # scientific notation
+
+    # BATCH mode: the query above plus BATCH - 1 more, each block scored
+    # against all of them; golden holds the lists query by query
+    batch = np.random.randn(BATCH - 1, VECTOR_SIZE).astype(np.float32)
+    batch = np.vstack([query, batch / np.linalg.norm(batch, axis=1, keepdims=True)])
+    write_file_one_per_line('input0_batch.txt', np.tile(batch.reshape(-1), NUM_VECTORS // BLOCK_ROWS))
+    batch_dots = targets @ batch.T
+    with open('golden_batch.txt', 'w') as f:
+        for b in range(0, NUM_VECTORS, BLOCK_ROWS):
+            for q in range(BATCH):
+                for score, index in block_topk(batch_dots[b:b + BLOCK_ROWS, q], attrs[b:b + BLOCK_ROWS]):
+                    f.write(f"{score:.9e}\n")
+                    f.write(f"{float(index):.9e}\n")
 
     print(f"Max dot product: {max_dot:.9e}")
 
@@ -4,38 +4,65 @@
 
 #include <iostream>
 #include <fstream>
+#include <cmath>
 #include "graph.hpp"
 
 simpleGraph vadd_graph;
 
+#if defined(__AIESIM__)
+// Cycles from the first corpus word on StreamIn1 until all vectors have
+// gone through; build with and without STREAM in graph.hpp to compare the
+// stream and window kernels
+static event::handle start_corpus_profiling(int vectors) {
+    return event::start_profiling(vadd_graph.p_s1, event::io_stream_start_to_bytes_transferred_cycles,
+                                  vectors * VECTOR_SIZE * sizeof(float));
+}
+
+static void report_corpus_cycles(event::handle h, int vectors) {
+    const long long cycles = event::read_profiling(h);
+    event::stop_profiling(h);
+#ifdef STREAM
+    std::cout << "stream kernel: ";
+#else
+    std::cout << "window kernel: ";
+#endif
+    std::cout << cycles << " cycles for " << vectors << " corpus vectors, "
+              << (double)cycles / vectors << " per vector" << std::endl;
+}
+#endif
+
 #if defined(__AIESIM__) || defined(__X86SIM__)
 int main(int argc, char** argv) {
     vadd_graph.init();
-#ifdef STREAM
-    vadd_graph.run(512);
-#else
-   int total_vectors = 256; // for example
-    int block_size = 128;
-    int num_blocks = total_vectors / block_size;
+    // input1.txt holds total_vectors corpus vectors; they stream through the
+    // kernel one VADD_MAX_ROWS block per iteration and the rows parameter
+    // tells the kernel how much of the last block is live
+    const int total_vectors = 256;
+    const int num_blocks = (total_vectors + VADD_MAX_ROWS - 1) / VADD_MAX_ROWS;
+#if defined(__AIESIM__)
+    event::handle corpus_cycles = start_corpus_profiling(total_vectors);
+#endif
 
+    vadd_graph.update(vadd_graph.k, VADD_MAX_K);
+    vadd_graph.update(vadd_graph.min_score, -1.0f);
+    vadd_graph.update(vadd_graph.mask, (int32)0x80000005);  // QUERY_MASK in gen_test_data.py
     for (int i = 0; i < num_blocks; ++i)
     {
-        // update input file pointers to load next 128 vectors
-        std::string in1_filename = "../data/input1_block" + std::to_string(i) + ".txt";
-        std::ofstream in1_block(in1_filename);
-        // write 128 vectors from global memory or file
-
-        // update PLIO source dynamically if needed
-        vadd_graph.p_s1 = input_plio::create("StreamIn1", plio_32_bits, in1_filename.c_str());
-
+        const int left = total_vectors - i * VADD_MAX_ROWS;
+        vadd_graph.update(vadd_graph.rows, left < VADD_MAX_ROWS ? left : VADD_MAX_ROWS);
         vadd_graph.run(1);
         vadd_graph.wait();
     }
-    vadd_graph.end();
+#if defined(__AIESIM__)
+    report_corpus_cycles(corpus_cycles, total_vectors);
 #endif
     vadd_graph.end();
     std::ifstream golden_file, aie_file;
+#ifdef BATCH
+    golden_file.open("../data/golden_batch.txt");
+#else
     golden_file.open("../data/golden.txt");
+#endif
     if(golden_file.fail()){
       std::cerr << "Error opening golden file." << std::endl;
       golden_file.close();
@@ -63,7 +90,7 @@ int main(int argc, char** argv) {
         }
         while (line_aie[0]=='T')
             getline(aie_file, line_aie);
-        if (std::stoi(line_golden) != std::stoi(line_aie)){
+        if (std::fabs(std::stof(line_golden) - std::stof(line_aie)) > 1e-4f){
             match = false;
             break;
         }
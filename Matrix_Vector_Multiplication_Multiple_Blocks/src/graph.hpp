@@ -9,15 +9,7 @@
 #include "kernels.hpp"
 
 // #define STREAM
-
-#ifdef STREAM
-#define INPUT_CONNECTION stream
-#define OUTPUT_CONNECTION stream
-#else
-#define INPUT_CONNECTION1 window<32 * sizeof(float)>
-#define INPUT_CONNECTION2 window<32 * 128 * sizeof(float)>
-#define OUTPUT_CONNECTION window<2 * sizeof(float)>
-#endif
+// #define BATCH
 
 using namespace adf;
 
@@ -29,25 +21,45 @@ class simpleGraph : public graph {
         input_plio p_s0;
         input_plio p_s1;
         output_plio p_s2;
+        input_plio p_s3;    // attribute words
+        // runtime parameters: live corpus rows, K, minimum score and the
+        // attribute mask of the query
+        port<input> rows;
+        port<input> k;
+        port<input> min_score;
+        port<input> mask;
 
         simpleGraph() {
             // create kernel & define source code
 #ifdef STREAM
-            vadd = kernel::create(aie_vadd_stream);
+            vadd = kernel::create(aie_vadd_stream<VADD_MAX_ROWS, VADD_MAX_K>);
             source(vadd) = "vadd_stream.cc";
+#elif defined(BATCH)
+            vadd = kernel::create(aie_vadd_window_batched<VADD_MAX_ROWS, VADD_MAX_K, VADD_BATCH>);
+            source(vadd) = "vadd_window.cc";
 #else
-            vadd = kernel::create(aie_vadd_window);
+            vadd = kernel::create(aie_vadd_window<VADD_MAX_ROWS, VADD_MAX_K>);
             source(vadd) = "vadd_window.cc";
 #endif
             // Define connection names and text file source/sink
+#ifdef BATCH
+            p_s0 = input_plio::create("StreamIn0", plio_32_bits, "data/input0_batch.txt");
+#else
             p_s0 = input_plio::create("StreamIn0", plio_32_bits, "data/input0.txt");
+#endif
             p_s1 = input_plio::create("StreamIn1", plio_32_bits, "data/input1.txt");
             p_s2 = output_plio::create("StreamOut0", plio_32_bits, "output.txt");
+            p_s3 = input_plio::create("StreamIn2", plio_32_bits, "data/input2.txt");
 
-            //connect ports and kernel
-            connect<INPUT_CONNECTION1>(p_s0.out[0], vadd.in[0]);
-            connect<INPUT_CONNECTION2>(p_s1.out[0], vadd.in[1]);
-            connect<OUTPUT_CONNECTION>(vadd.out[0], p_s2.in[0]);
+            //connect ports and kernel; buffer sizes come from the kernel signature
+            connect(p_s0.out[0], vadd.in[0]);
+            connect(p_s1.out[0], vadd.in[1]);
+            connect(vadd.out[0], p_s2.in[0]);
+            connect(p_s3.out[0], vadd.in[2]);
+            connect<parameter>(rows, async(vadd.in[3]));
+            connect<parameter>(k, async(vadd.in[4]));
+            connect<parameter>(min_score, async(vadd.in[5]));
+            connect<parameter>(mask, async(vadd.in[6]));
 
             // Define kernel runtime ratio
             runtime<ratio>(vadd) = 1;
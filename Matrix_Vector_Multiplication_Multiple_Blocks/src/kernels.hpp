@@ -5,10 +5,33 @@
 #ifndef __KERNELS_H__
 #define __KERNELS_H__
 
-#include <adf/stream/types.h>
+#include <adf.h>
 
-void aie_vadd_stream(input_stream_int32 *in0, input_stream_int32 *in1, output_stream_int32 *out);
+// Upper bounds of the runtime parameters of aie_vadd_window: corpus vectors
+// per window and result pairs per query. Every corpus vector also carries
+// one int32 attribute word (in2).
+#define VECTOR_SIZE 32
+#define VADD_MAX_ROWS 128
+#define VADD_MAX_K 8
+// Queries per invocation of aie_vadd_window_batched (BATCH in graph.hpp)
+#define VADD_BATCH 4
 
-void aie_vadd_window(input_window<float> *in0, input_window<float> *in1, output_window<float> *out);
+template <unsigned MAX_ROWS, unsigned MAX_K>
+void aie_vadd_window(adf::input_async_buffer<float, adf::extents<VECTOR_SIZE>>& in0,
+                     adf::input_async_buffer<float, adf::extents<VECTOR_SIZE * MAX_ROWS>>& in1,
+                     adf::input_buffer_1d<int32, MAX_ROWS>& in2,
+                     adf::output_buffer_1d<float, 2 * MAX_K>& out,
+                     int32 rows, int32 k, float min_score, int32 mask);
+
+template <unsigned MAX_ROWS, unsigned MAX_K>
+void aie_vadd_stream(input_stream<float> *in0, input_stream<float> *in1, input_stream<int32> *in2,
+                     output_stream<float> *out, int32 rows, int32 k, float min_score, int32 mask);
+
+template <unsigned MAX_ROWS, unsigned MAX_K, unsigned NQ>
+void aie_vadd_window_batched(adf::input_async_buffer<float, adf::extents<NQ * VECTOR_SIZE>>& in0,
+                             adf::input_async_buffer<float, adf::extents<VECTOR_SIZE * MAX_ROWS>>& in1,
+                             adf::input_buffer_1d<int32, MAX_ROWS>& in2,
+                             adf::output_buffer_1d<float, NQ * 2 * MAX_K>& out,
+                             int32 rows, int32 k, float min_score, int32 mask);
 
 #endif /**********__KERNELS_H__**********/
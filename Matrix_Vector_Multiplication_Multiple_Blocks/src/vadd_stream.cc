@@ -4,10 +4,60 @@
 
 #include <adf.h>
 #include "aie_api/aie.hpp"
+#include "aie_api/aie_adf.hpp"
+#include "kernels.hpp"
 
-void aie_vadd_stream(input_stream_int32 *in0, input_stream_int32 *in1, output_stream_int32 *out){
-    aie::vector<int32, 4> a = readincr_v4(in0);
-    aie::vector<int32, 4> b = readincr_v4(in1);
-    aie::vector<int32, 4> res = aie::add(a, b);
-    writeincr_v4(out, res);
-}
\ No newline at end of file
+// Stream twin of aie_vadd_window: the query arrives once on in0, then the
+// rows live corpus vectors on in1 and their attribute words on in2, all
+// read straight off the streams four floats at a time with no window
+// buffering. The dot product of each corpus vector is accumulated in an
+// accfloat register and only the reduced score touches memory. Same runtime
+// parameters, filter and (score, index) output as the window kernel.
+template <unsigned MAX_ROWS, unsigned MAX_K>
+void aie_vadd_stream(input_stream<float> *in0, input_stream<float> *in1, input_stream<int32> *in2,
+                     output_stream<float> *out, int32 rows, int32 k, float min_score, int32 mask){
+
+    constexpr unsigned L = 4;       // floats per stream read
+    constexpr unsigned C = VECTOR_SIZE / L;
+
+    aie::vector<float, L> a[C];
+    for (unsigned c = 0; c < C; c++)
+        a[c] = readincr_v<L>(in0);
+
+    const unsigned n = rows < 1 ? 0 : (rows < (int32)MAX_ROWS ? rows : MAX_ROWS);
+    const unsigned kk = k < 1 ? 1 : (k < (int32)MAX_K ? k : MAX_K);
+
+    float topScore[MAX_K];
+    float topIndex[MAX_K];
+    for (unsigned j = 0; j < MAX_K; j++) {
+        topScore[j] = -1e30f;
+        topIndex[j] = -1;
+    }
+
+    float threshold = min_score;
+    for (unsigned int i=0; i<n; i++) {
+        aie::accum<accfloat, L> acc = aie::mul(a[0], readincr_v<L>(in1));
+        for (unsigned c = 1; c < C; c++)
+            acc = aie::mac(acc, a[c], readincr_v<L>(in1));
+        const float dot_product = aie::reduce_add(acc.to_vector<float>());
+        const int32 attr = readincr(in2);
+        if ((attr & mask) == mask && dot_product > threshold) {
+            unsigned p = kk - 1;
+            while (p > 0 && topScore[p - 1] < dot_product) {
+                topScore[p] = topScore[p - 1];
+                topIndex[p] = topIndex[p - 1];
+                --p;
+            }
+            topScore[p] = dot_product;
+            topIndex[p] = i;
+            if (topIndex[kk - 1] >= 0)
+                threshold = topScore[kk - 1];
+        }
+    }
+
+    for (unsigned j = 0; j < MAX_K; j++) {
+        const bool used = topIndex[j] >= 0;
+        writeincr(out, used ? topScore[j] : -1.0f);
+        writeincr(out, topIndex[j]);
+    }
+}
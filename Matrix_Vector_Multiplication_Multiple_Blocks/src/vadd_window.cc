@@ -5,26 +5,139 @@
 #include <aie_api/aie.hpp>
 #include <aie_api/aie_adf.hpp>
 #include <aie_api/utils.hpp>
+#include "kernels.hpp"
 
-
-void aie_vadd_window(input_window<float> *in0, input_window<float> *in1, output_window<float> *out){
+// Best k (dot product, index) pairs of the query in in0 against the corpus
+// vectors in in1. The buffer always holds MAX_ROWS vectors; the runtime
+// parameters pick how many of them are live (rows), how many pairs to keep
+// (k <= MAX_K) and the score a vector has to beat (min_score). Slots that
+// stay empty are written as (-1, -1). in2 holds one attribute word per
+// corpus vector; only vectors carrying every bit of the query's mask
+// ((attr & mask) == mask) compete for the top-k, so mask 0 disables the
+// filter. in0 and in1 are async buffers: the query is released once it
+// sits in a register and the corpus as soon as the scan is done, so the
+// DMA of the next block overlaps the rest of the kernel.
+template <unsigned MAX_ROWS, unsigned MAX_K>
+void aie_vadd_window(adf::input_async_buffer<float, adf::extents<VECTOR_SIZE>>& in0,
+                     adf::input_async_buffer<float, adf::extents<VECTOR_SIZE * MAX_ROWS>>& in1,
+                     adf::input_buffer_1d<int32, MAX_ROWS>& in2,
+                     adf::output_buffer_1d<float, 2 * MAX_K>& out,
+                     int32 rows, int32 k, float min_score, int32 mask){
 
     float dot_product = 0;
-    aie::vector<float, 32> a = window_readincr_v<32>(in0);
+    in0.acquire();
+    aie::vector<float, VECTOR_SIZE> a = aie::load_v<VECTOR_SIZE>(in0.data());
+    in0.release();
+
+    const unsigned n = rows < 1 ? 0 : (rows < (int32)MAX_ROWS ? rows : MAX_ROWS);
+    const unsigned kk = k < 1 ? 1 : (k < (int32)MAX_K ? k : MAX_K);
+
+    float topScore[MAX_K];
+    float topIndex[MAX_K];
+    for (unsigned j = 0; j < MAX_K; j++) {
+        topScore[j] = -1e30f;
+        topIndex[j] = -1;
+    }
 
-    float max_dot = 0;
-    float index = -1;
-    for (unsigned int i=0; i<128; i++) {
-        aie::vector<float, 32> b = window_readincr_v<32>(in1);
+    float threshold = min_score;
+    in1.acquire();
+    const float* corpus = in1.data();
+    const int32* attrs = in2.data();
+    for (unsigned int i=0; i<n; i++) {
+        aie::vector<float, VECTOR_SIZE> b = aie::load_v<VECTOR_SIZE>(corpus + i * VECTOR_SIZE);
         auto c = aie::mul(a, b);
         auto va = c.to_vector<float>(0);
         dot_product = aie::reduce_add(va);
-        if (dot_product > max_dot) {
-            max_dot = dot_product;
-            index = i;
+        const int32 attr = attrs[i];
+        if ((attr & mask) == mask && dot_product > threshold) {
+            unsigned p = kk - 1;
+            while (p > 0 && topScore[p - 1] < dot_product) {
+                topScore[p] = topScore[p - 1];
+                topIndex[p] = topIndex[p - 1];
+                --p;
+            }
+            topScore[p] = dot_product;
+            topIndex[p] = i;
+            if (topIndex[kk - 1] >= 0)
+                threshold = topScore[kk - 1];
         }
     }
+    in1.release();
+
+    auto o = aie::begin(out);
+    for (unsigned j = 0; j < MAX_K; j++) {
+        const bool used = topIndex[j] >= 0;
+        *o++ = used ? topScore[j] : -1.0f;
+        *o++ = topIndex[j];
+    }
+}
+
+// Batched aie_vadd_window: in0 holds NQ queries that stay in tile memory
+// for the whole window, and every corpus vector read from in1 is scored
+// against all of them, so the corpus is read once per NQ queries instead of
+// once per query. Each query keeps its own top-k list and threshold; the
+// runtime parameters and the attribute mask apply to the whole batch. out
+// holds MAX_K (score, index) pairs per query, query by query. Buffers are
+// released early as in aie_vadd_window.
+template <unsigned MAX_ROWS, unsigned MAX_K, unsigned NQ>
+void aie_vadd_window_batched(adf::input_async_buffer<float, adf::extents<NQ * VECTOR_SIZE>>& in0,
+                             adf::input_async_buffer<float, adf::extents<VECTOR_SIZE * MAX_ROWS>>& in1,
+                             adf::input_buffer_1d<int32, MAX_ROWS>& in2,
+                             adf::output_buffer_1d<float, NQ * 2 * MAX_K>& out,
+                             int32 rows, int32 k, float min_score, int32 mask){
+
+    aie::vector<float, VECTOR_SIZE> a[NQ];
+    in0.acquire();
+    for (unsigned q = 0; q < NQ; q++)
+        a[q] = aie::load_v<VECTOR_SIZE>(in0.data() + q * VECTOR_SIZE);
+    in0.release();
 
-    window_writeincr(out, max_dot);
-    window_writeincr(out, index);
-}
\ No newline at end of file
+    const unsigned n = rows < 1 ? 0 : (rows < (int32)MAX_ROWS ? rows : MAX_ROWS);
+    const unsigned kk = k < 1 ? 1 : (k < (int32)MAX_K ? k : MAX_K);
+
+    float topScore[NQ * MAX_K];
+    float topIndex[NQ * MAX_K];
+    float threshold[NQ];
+    for (unsigned j = 0; j < NQ * MAX_K; j++) {
+        topScore[j] = -1e30f;
+        topIndex[j] = -1;
+    }
+    for (unsigned q = 0; q < NQ; q++)
+        threshold[q] = min_score;
+
+    in1.acquire();
+    const float* corpus = in1.data();
+    const int32* attrs = in2.data();
+    for (unsigned int i=0; i<n; i++) {
+        aie::vector<float, VECTOR_SIZE> b = aie::load_v<VECTOR_SIZE>(corpus + i * VECTOR_SIZE);
+        const int32 attr = attrs[i];
+        if ((attr & mask) != mask)
+            continue;
+        for (unsigned q = 0; q < NQ; q++) {
+            auto c = aie::mul(a[q], b);
+            const float dot_product = aie::reduce_add(c.to_vector<float>(0));
+            if (dot_product > threshold[q]) {
+                float* score = topScore + q * MAX_K;
+                float* index = topIndex + q * MAX_K;
+                unsigned p = kk - 1;
+                while (p > 0 && score[p - 1] < dot_product) {
+                    score[p] = score[p - 1];
+                    index[p] = index[p - 1];
+                    --p;
+                }
+                score[p] = dot_product;
+                index[p] = i;
+                if (index[kk - 1] >= 0)
+                    threshold[q] = score[kk - 1];
+            }
+        }
+    }
+    in1.release();
+
+    auto o = aie::begin(out);
+    for (unsigned j = 0; j < NQ * MAX_K; j++) {
+        const bool used = topIndex[j] >= 0;
+        *o++ = used ? topScore[j] : -1.0f;
+        *o++ = topIndex[j];
+    }
+}
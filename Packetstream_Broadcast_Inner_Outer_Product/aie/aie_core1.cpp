@@ -17,17 +17,35 @@ limitations under the License.
 
 const uint32 pktType = 0;
 
+// Closes a result packet with the TRACE_WORDS cycle stamps of STAGE_TRACE;
+// the kernel's last result word carries TLAST only when TRACE_WORDS is 0
+static inline void write_trace(output_pktstream *out, uint64 entry) {
+#ifdef STAGE_TRACE
+	writeincr(out, (int32)(uint32)entry);
+	writeincr(out, (int32)(uint32)aie::tile::current().cycles(), true);
+#else
+	(void)out;
+	(void)entry;
+#endif
+}
+
 
+// Column max (and the row reaching it) of C = A x B, A and B in MMUL tile order.
+// With attr/mask set, row r only counts for column j when
+// (attr[r] & mask[j]) == mask[j]; a column no row passes keeps -1e30 / -1.
 static inline void matmult_float_buf(const float* __restrict A,
 									 const float* __restrict B,
 									 float* __restrict colMax,
+									 int32* __restrict colArg,
 									 unsigned Ra, unsigned Ca,
-									 unsigned Rb, unsigned Cb) {
+									 unsigned Rb, unsigned Cb,
+									 const int32* __restrict attr = nullptr,
+									 const int32* __restrict mask = nullptr) {
 	constexpr unsigned M = 4;
 	constexpr unsigned K = 2;
 	constexpr unsigned N = 4;
 
-	for (unsigned j = 0; j < Cb; ++j) colMax[j] = -1e30f;
+	for (unsigned j = 0; j < Cb; ++j) { colMax[j] = -1e30f; colArg[j] = -1; }
 
 	const unsigned rowA = Ra / M;
 	const unsigned colA = Ca / K;
@@ -59,18 +77,31 @@ static inline void matmult_float_buf(const float* __restrict A,
 			for (unsigned n = 0; n < N; ++n) {
 				const unsigned gcol = jb * N + n;
 				float curMax = colMax[gcol];
+				int32 curArg = colArg[gcol];
 				for (unsigned m = 0; m < M; ++m) {
 					float v = Cblk[m * N + n];
-					if (v > curMax) curMax = v;
+					if (attr && (attr[z * M + m] & mask[gcol]) != mask[gcol]) continue;
+					if (v > curMax) { curMax = v; curArg = z * M + m; }
 				}
 				colMax[gcol] = curMax;
+				colArg[gcol] = curArg;
 			}
 		}
 	}
 }
 
+// Corpus block (payload of the packet on in0, header already read) and the
+// broadcast query batch on in1, int32 values converted to float
+static inline void read_int_block(input_pktstream *in0, input_stream<int32> *in1,
+								  float* __restrict A, float* __restrict B) {
+	bool tlast;
+	for (unsigned i = 0; i < F_Ra * F_Ca; ++i) { int32 v = readincr(in0, tlast); A[i] = (float)v; }
+	for (unsigned i = 0; i < F_Rb * F_Cb; ++i) { int32 v = readincr(in1);         B[i] = (float)v; }
+}
+
 void aie_core1(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out) {
 
+	const uint64 entry = aie::tile::current().cycles();
 	readincr(in0);
 	uint32 ID = getPacketid(out, 0);
 	writeHeader(out, pktType, ID);
@@ -86,141 +117,267 @@ void aie_core1(input_pktstream *in0, input_stream<int32> *in1, output_pktstream
 
 	static float A[F_Ra * F_Ca];
 	static float B[F_Rb * F_Cb];
-	bool tlast;
-	for (unsigned i = 0; i < Ra * Ca; ++i) { int32 v = readincr(in0, tlast); A[i] = (float)v; }
-	for (unsigned i = 0; i < Rb * Cb; ++i) { int32 v = readincr(in1);         B[i] = (float)v; }
+	read_int_block(in0, in1, A, B);
 	static float colMax[F_Cb];
-	matmult_float_buf(A, B, colMax, Ra, Ca, Rb, Cb);
+	static int32 colArg[F_Cb];
+	matmult_float_buf(A, B, colMax, colArg, Ra, Ca, Rb, Cb);
 
 	for (unsigned j = 0; j < Cb; ++j) {
-		writeincr(out, (int32)colMax[j], j == (Cb - 1));
+		writeincr(out, (int32)colMax[j], TRACE_WORDS == 0 && j == (Cb - 1));
+	}
+	write_trace(out, entry);
+}
+
+// aie_core1 for the WIDE_INGEST mode. The block arrives split by rows over
+// two ports: in0 carries rows 0 and 2 of every 4x2 MMUL tile, in1 rows 1
+// and 3, so both streams are drained in the same loop iteration and the
+// tile fills at twice the rate of a single port. Packet streams only have
+// scalar reads; the query batch on in2 is a plain stream and comes in 128
+// bits at a time.
+void aie_core1_dual(input_pktstream *in0, input_pktstream *in1, input_stream<int32> *in2, output_pktstream *out) {
+
+	const uint64 entry = aie::tile::current().cycles();
+	readincr(in0);
+	readincr(in1);
+	uint32 ID = getPacketid(out, 0);
+	writeHeader(out, pktType, ID);
+
+	static float A[F_Ra * F_Ca];
+	alignas(32) static float B[F_Rb * F_Cb];
+	bool tlast;
+	for (unsigned t = 0; t < F_Ra * F_Ca; t += 8)
+		chess_prepare_for_pipelining
+	{
+		A[t + 0] = (float)readincr(in0, tlast);
+		A[t + 2] = (float)readincr(in1, tlast);
+		A[t + 1] = (float)readincr(in0, tlast);
+		A[t + 3] = (float)readincr(in1, tlast);
+		A[t + 4] = (float)readincr(in0, tlast);
+		A[t + 6] = (float)readincr(in1, tlast);
+		A[t + 5] = (float)readincr(in0, tlast);
+		A[t + 7] = (float)readincr(in1, tlast);
+	}
+	for (unsigned p = 0; p < WIDE_PKT_PAD; ++p) {
+		readincr(in0, tlast);
+		readincr(in1, tlast);
+	}
+	for (unsigned i = 0; i < F_Rb * F_Cb; i += 4)
+		aie::store_v(B + i, aie::to_float(readincr_v<4>(in2), 0));
+
+	static float colMax[F_Cb];
+	static int32 colArg[F_Cb];
+	matmult_float_buf(A, B, colMax, colArg, F_Ra, F_Ca, F_Rb, F_Cb);
+
+	for (unsigned j = 0; j < F_Cb; ++j) {
+		writeincr(out, (int32)colMax[j], TRACE_WORDS == 0 && j == (F_Cb - 1));
+	}
+	write_trace(out, entry);
+}
+
+// aie_core1 with the attribute filter of the ATTRIBUTE_FILTER mode. The
+// corpus packet carries F_Ra attribute words after the block and the query
+// batch F_Cb mask words after the queries. Queries no row of the shard
+// passes report INT32_MIN, which never wins in hls_packet_receiver.
+void aie_core1_filtered(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out) {
+
+	const uint64 entry = aie::tile::current().cycles();
+	readincr(in0);
+	uint32 ID = getPacketid(out, 0);
+	writeHeader(out, pktType, ID);
+
+	static float A[F_Ra * F_Ca];
+	static float B[F_Rb * F_Cb];
+	read_int_block(in0, in1, A, B);
+	static int32 attr[F_Ra];
+	static int32 mask[F_Cb];
+	bool tlast;
+	for (unsigned i = 0; i < F_Ra; ++i) attr[i] = readincr(in0, tlast);
+	for (unsigned j = 0; j < F_Cb; ++j) mask[j] = readincr(in1);
+
+	static float colMax[F_Cb];
+	static int32 colArg[F_Cb];
+	matmult_float_buf(A, B, colMax, colArg, F_Ra, F_Ca, F_Rb, F_Cb, attr, mask);
+
+	for (unsigned j = 0; j < F_Cb; ++j) {
+		const int32 score = colArg[j] < 0 ? (int32)0x80000000 : (int32)colMax[j];
+		writeincr(out, score, TRACE_WORDS == 0 && j == (F_Cb - 1));
+	}
+	write_trace(out, entry);
+}
+
+// Thresholded aie_core1 for the THRESHOLD_EMIT mode: the same column max,
+// but only queries whose best score beats min_score (runtime parameter) are
+// emitted, each as a (score, id) pair with id = query << 16 | row. The
+// packet is closed by a hit-count word carrying TLAST, so its length varies
+// and a shard without hits sends just the header and the count.
+void aie_core1_threshold(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out, int32 min_score) {
+
+	readincr(in0);
+	uint32 ID = getPacketid(out, 0);
+	writeHeader(out, pktType, ID);
+
+	static float A[F_Ra * F_Ca];
+	static float B[F_Rb * F_Cb];
+	read_int_block(in0, in1, A, B);
+	static float colMax[F_Cb];
+	static int32 colArg[F_Cb];
+	matmult_float_buf(A, B, colMax, colArg, F_Ra, F_Ca, F_Rb, F_Cb);
+
+	int32 hits = 0;
+	for (unsigned j = 0; j < F_Cb; ++j) {
+		const int32 score = (int32)colMax[j];
+		if (score > min_score) {
+			writeincr(out, score);
+			writeincr(out, (int32)(j << 16) | colArg[j]);
+			++hits;
+		}
 	}
+	writeincr(out, hits, true);
 }
 
-/// this is the code for outer product 
-
-// #include <aie_api/aie.hpp>
-// #include <aie_api/aie_adf.hpp>
-// #include "system_settings.h"
-
-// // Packet type forwarded to output
-// const uint32 pktType = 0;
-
-// // Configuration constants for this kernel
-// constexpr unsigned Ra_cfg = 4;   // rows of Q (queries)
-// constexpr unsigned Ca_cfg = 16;  // cols of Q (embedding dim)
-// constexpr unsigned Rb_cfg = 16;  // rows of V (= Ca)
-// constexpr unsigned Cb_cfg = 4;   // cols of V (database vectors)
-
-// // Block sizes for MMUL tiling
-// constexpr unsigned M = 4;
-// constexpr unsigned Kt = 2; // small k-block size (matches aie::mmul K)
-// constexpr unsigned N = 4;
-
-// // Default: output row-wise maxima. Undefine to output full C matrix.
-// #ifndef OUTPUT_MAXIMA
-// #define OUTPUT_MAXIMA 1
-// #endif
-
-// // Safety: tile-local memory budget in bytes (VCK5000 safe baseline)
-// constexpr size_t TILE_LOCAL_BYTES = 32 * 1024;
-// constexpr size_t STACK_RESERVE = 8 * 1024; // reserve for stack/other usage
-
-// // Static BSS buffers (tile-local, aligned). These keep memory off the stack.
-// static float C_accum[Ra_cfg * Cb_cfg] __attribute__((aligned(32)));
-// static float A_block[Ra_cfg * Kt] __attribute__((aligned(32)));
-// static float B_block[Kt * Cb_cfg] __attribute__((aligned(32)));
-
-// // Compile-time memory safety check
-// static_assert((sizeof(C_accum) + sizeof(A_block) + sizeof(B_block) + STACK_RESERVE) <= TILE_LOCAL_BYTES,
-//               "Tile-local buffers + stack reserve exceed TILE_LOCAL_BYTES (32KB). Reduce allocations.");
-
-// void aie_core1(input_pktstream *inV, input_stream<int32> *inQ, output_pktstream *out) {
-//     // 1) Consume input pktstream header for V and forward header to output
-//     readincr(inV); // consume header word from inV
-//     uint32 ID = getPacketid(out, 0);
-//     writeHeader(out, pktType, ID);
-
-//     // 2) Dimensions
-//     const unsigned Ra = Ra_cfg;
-//     const unsigned Ca = Ca_cfg;
-//     const unsigned Rb = Rb_cfg;
-//     const unsigned Cb = Cb_cfg;
-//     const unsigned K = (Ca < Rb) ? Ca : Rb;
-//     const unsigned k_block = Kt;
-//     const unsigned Ksteps = K / k_block;
-
-//     // 3) Initialize accumulator to zero
-//     for (unsigned i = 0; i < Ra * Cb; ++i) C_accum[i] = 0.0f;
-
-//     // Temporary MxN buffer used for storing mmul block outputs
-//     float Cblk[M * N] __attribute__((aligned(32)));
-
-//     // 4) Streaming k-block outer-product accumulation
-//     using MMUL = aie::mmul<M, Kt, N, float, float>;
-//     const unsigned rowA = Ra / M;
-//     const unsigned colB = Cb / N;
-
-//     for (unsigned step = 0; step < Ksteps; ++step) {
-//         const unsigned kbase = step * k_block;
-
-//         // Read A_block from broadcast stream inQ
-//         for (unsigned kb = 0; kb < k_block; ++kb) {
-//             for (unsigned r = 0; r < Ra; ++r) {
-//                 int32 v = readincr(inQ);
-//                 A_block[r * k_block + kb] = (float)v;
-//             }
-//         }
-
-//         // Read B_block from pktstream inV
-//         for (unsigned kb = 0; kb < k_block; ++kb) {
-//             bool tlast = false;
-//             for (unsigned j = 0; j < Cb; ++j) {
-//                 int32 v = readincr(inV, tlast);
-//                 B_block[kb * Cb + j] = (float)v;
-//             }
-//         }
-
-//         // Tile the partial product with mmul blocks
-//         for (unsigned z = 0; z < rowA; ++z) {
-//             for (unsigned jb = 0; jb < colB; ++jb) {
-//                 MMUL acc;
-//                 const float *a_ptr = A_block + (z * M) * k_block;
-//                 const float *b_ptr = B_block + jb * MMUL::size_B;
-//                 auto a_vec = aie::load_v<MMUL::size_A>(a_ptr);
-//                 auto b_vec = aie::load_v<MMUL::size_B>(b_ptr);
-//                 acc.mul(a_vec, b_vec);
-//                 aie::store_v(Cblk, acc.template to_vector<float>());
-
-//                 for (unsigned m = 0; m < M; ++m) {
-//                     const unsigned global_r = z * M + m;
-//                     float *Crow = &C_accum[global_r * Cb];
-//                     for (unsigned n = 0; n < N; ++n) {
-//                         const unsigned global_c = jb * N + n;
-//                         Crow[global_c] += Cblk[m * N + n];
-//                     }
-//                 }
-//             }
-//         }
-//     }
-
-//     // 5) Post-process and write output
-// #if OUTPUT_MAXIMA
-//     for (unsigned r = 0; r < Ra; ++r) {
-//         float rowMax = -1e30f;
-//         for (unsigned j = 0; j < Cb; ++j) {
-//             float v = C_accum[r * Cb + j];
-//             if (v > rowMax) rowMax = v;
-//         }
-//         const bool last = (r == (Ra - 1));
-//         writeincr(out, (int32)rowMax, last);
-//     }
-// #else
-//     for (unsigned r = 0; r < Ra; ++r) {
-//         for (unsigned j = 0; j < Cb; ++j) {
-//             const bool last = (r == (Ra - 1)) && (j == (Cb - 1));
-//             writeincr(out, (int32)C_accum[r * Cb + j], last);
-//         }
-//     }
-// #endif
-// }
+// Float rescoring stage behind aie_hamming_prefilter, one packet per query.
+// For each of the F_Cb queries, in0 carries the number of live candidates
+// and then the RR_ROWS candidate rows the host gathered from that query's
+// prefilter results (raw float bits, row-major, padding after the live
+// ones), in1 the query itself. Every live row is scored with an 8-lane
+// float dot product: matmult_float_buf only keeps one argmax per query, not
+// a top-K. Emits one packet per query with its RR_TOPK best (score bits,
+// candidate slot) pairs, best first and ties to the lower slot; slots past
+// the live count never enter, unused pairs are -1e30 / -1. The host maps
+// slots back to corpus ids.
+void aie_rerank(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out) {
+
+	uint32 ID = getPacketid(out, 0);
+	alignas(32) static float A[RR_ROWS * F_Ca];
+	alignas(32) static float q[F_Ca];
+	int32* Ai = reinterpret_cast<int32*>(A);
+	int32* qi = reinterpret_cast<int32*>(q);
+	bool tlast;
+
+	for (unsigned query = 0; query < F_Cb; ++query) {
+		readincr(in0);
+		const int32 count = readincr(in0, tlast);
+		const unsigned live = count < 1 ? 0 : (count < RR_ROWS ? count : RR_ROWS);
+		for (unsigned i = 0; i < RR_ROWS * F_Ca; ++i) Ai[i] = readincr(in0, tlast);
+		for (unsigned i = 0; i < F_Ca; ++i) qi[i] = readincr(in1);
+
+		float topScore[RR_TOPK];
+		int32 topSlot[RR_TOPK];
+		for (unsigned t = 0; t < RR_TOPK; ++t) { topScore[t] = -1e30f; topSlot[t] = -1; }
+
+		for (unsigned r = 0; r < live; ++r) {
+			aie::accum<accfloat, 8> acc = aie::zeros<accfloat, 8>();
+			for (unsigned d = 0; d < F_Ca; d += 8)
+				acc = aie::mac(acc, aie::load_v<8>(A + r * F_Ca + d), aie::load_v<8>(q + d));
+			const float s = aie::reduce_add(acc.template to_vector<float>());
+			if (s <= topScore[RR_TOPK - 1]) continue;
+			unsigned p = RR_TOPK - 1;
+			while (p > 0 && topScore[p - 1] < s) {
+				topScore[p] = topScore[p - 1];
+				topSlot[p] = topSlot[p - 1];
+				--p;
+			}
+			topScore[p] = s;
+			topSlot[p] = r;
+		}
+
+		writeHeader(out, pktType, ID);
+		const int32* scoreBits = reinterpret_cast<const int32*>(topScore);
+		for (unsigned t = 0; t < RR_TOPK; ++t) {
+			writeincr(out, scoreBits[t]);
+			writeincr(out, topSlot[t], t == (RR_TOPK - 1));
+		}
+	}
+}
+
+// GMIO variant of aie_core1: the tile DMA fills in0 with one corpus block
+// and in1 with the query batch straight from DDR, both as floats in MMUL
+// tile order, so there is no header to strip and no int32 conversion.
+// Emits per query the best score and its row. The corpus block is released
+// before the output is written so the next block's DMA can start.
+void aie_core1_gmio(adf::input_async_buffer<float, adf::extents<F_Ra * F_Ca>>& __restrict in0,
+					adf::input_buffer_1d<float, F_Rb * F_Cb>& __restrict in1,
+					adf::output_buffer_1d<float, F_Cb * 2>& __restrict out) {
+
+	alignas(32) float colMax[F_Cb];
+	alignas(32) int32 colArg[F_Cb];
+	in0.acquire();
+	matmult_float_buf(in0.data(), in1.data(), colMax, colArg, F_Ra, F_Ca, F_Rb, F_Cb);
+	in0.release();
+
+	auto o = aie::begin(out);
+	for (unsigned j = 0; j < F_Cb; ++j) {
+		*o++ = colMax[j];
+		*o++ = (float)colArg[j];
+	}
+}
+
+// Outer-product form of aie_core1 for the OUTER_PRODUCT mode. The
+// embedding dimension is streamed OP_KB dimensions at a time: per k-block
+// the broadcast stream in1 carries column k of the OP_Ra queries for every
+// k of the block, and the packet on in0 row k of the OP_Cb corpus vectors.
+// The k-block is tiled in place into 4x2 (A) and 2x4 (B) MMUL tiles and
+// mac'd into C, which is held in 4x4 MMUL tile order, so the tile stores
+// C plus one k-block no matter how long the vectors are. Emits per query
+// the best score over the packet's vectors, like aie_core1.
+void aie_core1_outer(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out) {
+
+	const uint64 entry = aie::tile::current().cycles();
+	readincr(in0);
+	uint32 ID = getPacketid(out, 0);
+	writeHeader(out, pktType, ID);
+
+	constexpr unsigned M = 4;
+	constexpr unsigned K = 2;
+	constexpr unsigned N = 4;
+	using MMUL = aie::mmul<M, K, N, float, float>;
+	constexpr unsigned rowA = OP_Ra / M;
+	constexpr unsigned colA = OP_KB / K;
+	constexpr unsigned colB = OP_Cb / N;
+
+	alignas(32) static float C[OP_Ra * OP_Cb];
+	alignas(32) static float A[OP_Ra * OP_KB];
+	alignas(32) static float B[OP_KB * OP_Cb];
+
+	for (unsigned i = 0; i < OP_Ra * OP_Cb; i += MMUL::size_C)
+		aie::store_v(C + i, aie::zeros<float, MMUL::size_C>());
+
+	bool tlast;
+	for (unsigned step = 0; step < OP_DIM / OP_KB; ++step) {
+		for (unsigned kk = 0; kk < OP_KB; ++kk)
+			for (unsigned r = 0; r < OP_Ra; ++r)
+				A[((r / M) * colA + kk / K) * MMUL::size_A + (r % M) * K + kk % K] = (float)readincr(in1);
+		for (unsigned kk = 0; kk < OP_KB; ++kk)
+			for (unsigned j = 0; j < OP_Cb; ++j)
+				B[((kk / K) * colB + j / N) * MMUL::size_B + (kk % K) * N + j % N] = (float)readincr(in0, tlast);
+
+		for (unsigned z = 0; z < rowA; ++z) {
+			for (unsigned jb = 0; jb < colB; ++jb)
+				chess_prepare_for_pipelining
+			{
+				float* c_ptr = C + (z * colB + jb) * MMUL::size_C;
+				aie::accum<accfloat, MMUL::size_C> c;
+				c.from_vector(aie::load_v<MMUL::size_C>(c_ptr));
+				MMUL acc(c);
+				for (unsigned i = 0; i < colA; ++i) {
+					auto ai = aie::load_v<MMUL::size_A>(A + (z * colA + i) * MMUL::size_A);
+					auto bi = aie::load_v<MMUL::size_B>(B + (i * colB + jb) * MMUL::size_B);
+					acc.mac(ai, bi);
+				}
+				aie::store_v(c_ptr, acc.template to_vector<float>());
+			}
+		}
+	}
+
+	// row maxima: query r's scores sit in row r % M of the tiles (r / M, *)
+	for (unsigned r = 0; r < OP_Ra; ++r) {
+		float best = -1e30f;
+		for (unsigned jb = 0; jb < colB; ++jb) {
+			const float* row = C + ((r / M) * colB + jb) * MMUL::size_C + (r % M) * N;
+			for (unsigned n = 0; n < N; ++n)
+				if (row[n] > best) best = row[n];
+		}
+		writeincr(out, (int32)best, TRACE_WORDS == 0 && r == (OP_Ra - 1));
+	}
+	write_trace(out, entry);
+}
@@ -0,0 +1,89 @@
+#include <aie_api/aie.hpp>
+#include <aie_api/aie_adf.hpp>
+#include "system_settings.h"
+
+const uint32 pktType = 0;
+
+// popcount of each int32 lane (SWAR; AIE has no vector popcount). The masks
+// clear whatever the arithmetic shifts drag in from the sign bit.
+static inline aie::vector<int32, 8> popcount8(aie::vector<int32, 8> v) {
+	v = aie::sub(v, aie::bit_and(aie::downshift(v, 1), 0x55555555));
+	v = aie::add(aie::bit_and(v, 0x33333333), aie::bit_and(aie::downshift(v, 2), 0x33333333));
+	v = aie::bit_and(aie::add(v, aie::downshift(v, 4)), 0x0F0F0F0F);
+	v = aie::add(v, aie::downshift(v, 8));
+	v = aie::add(v, aie::downshift(v, 16));
+	return aie::bit_and(v, 0x3F);
+}
+
+// First pass of the binary mode. in0 carries BIN_ROWS sign-bit codes of this
+// shard, in1 the codes of the F_Cb queries. For every corpus code the XOR +
+// popcount distance to all queries is computed 8 queries per vector op, and
+// each query keeps its BIN_TOPR nearest codes. Emits per query BIN_TOPR
+// (hamming distance, corpus row) pairs, nearest first.
+void aie_hamming_prefilter(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out) {
+
+	readincr(in0);
+	uint32 ID = getPacketid(out, 0);
+	writeHeader(out, pktType, ID);
+
+	constexpr unsigned Q = F_Cb;
+	constexpr unsigned G = Q / 8;
+	constexpr unsigned R = BIN_TOPR;
+
+	// shard row offset, kept across graph iterations
+	static unsigned block = 0;
+	const int32 base = block * BIN_ROWS;
+
+	// query codes, word-major so one vector holds word w of 8 queries
+	alignas(32) static int32 qT[BIN_WORDS * Q];
+	for (unsigned q = 0; q < Q; ++q)
+		for (unsigned w = 0; w < BIN_WORDS; ++w)
+			qT[w * Q + q] = readincr(in1);
+
+	// per-query sorted lists; thr[q] is the distance a code must beat
+	static int32 topHam[Q * R];
+	static int32 topId[Q * R];
+	alignas(32) static int32 thr[Q];
+	for (unsigned i = 0; i < Q * R; ++i) { topHam[i] = BIN_DIM + 1; topId[i] = -1; }
+	for (unsigned q = 0; q < Q; ++q) thr[q] = BIN_DIM + 1;
+
+	bool tlast;
+	for (unsigned r = 0; r < BIN_ROWS; ++r) {
+		aie::vector<int32, 8> ham[G];
+		for (unsigned g = 0; g < G; ++g) ham[g] = aie::zeros<int32, 8>();
+
+		for (unsigned w = 0; w < BIN_WORDS; ++w) {
+			const auto x = aie::broadcast<int32, 8>(readincr(in0, tlast));
+			for (unsigned g = 0; g < G; ++g)
+				ham[g] = aie::add(ham[g], popcount8(aie::bit_xor(x, aie::load_v<8>(qT + w * Q + g * 8))));
+		}
+
+		for (unsigned g = 0; g < G; ++g) {
+			const auto hit = aie::lt(ham[g], aie::load_v<8>(thr + g * 8));
+			if (hit.empty()) continue;
+			for (unsigned l = 0; l < 8; ++l) {
+				if (!hit.test(l)) continue;
+				const unsigned q = g * 8 + l;
+				const int32 h = ham[g][l];
+				int32* lh = topHam + q * R;
+				int32* li = topId + q * R;
+				unsigned p = R - 1;
+				while (p > 0 && lh[p - 1] > h) {
+					lh[p] = lh[p - 1];
+					li[p] = li[p - 1];
+					--p;
+				}
+				lh[p] = h;
+				li[p] = base + r;
+				thr[q] = lh[R - 1];
+			}
+		}
+	}
+
+	for (unsigned i = 0; i < Q * R; ++i) {
+		writeincr(out, topHam[i]);
+		writeincr(out, topId[i], i == (Q * R - 1));
+	}
+
+	++block;
+}
@@ -2,11 +2,14 @@ import re
 from pathlib import Path
 from typing import List
 
-# ---------- Dimensions: must match aie_core1.cpp F_* ----------
-F_Ra = 16
-F_Ca = 8
+# ---------- Dimensions: must match aie/system_settings.h F_* ----------
+F_Ra = 128
+F_Ca = 32
 F_Rb = F_Ca
-F_Cb = 8
+F_Cb = 32
+# cycle stamps closing every result packet: 2 with STAGE_TRACE
+# (aie/system_settings.h), which is off by default
+TRACE_WORDS = 0
 
 ROOT = Path(__file__).resolve().parents[1]
 DATA_DIR = ROOT / "data"
@@ -16,6 +19,7 @@ OUT_DIR.mkdir(parents=True, exist_ok=True)
 IN0 = DATA_DIR / "input0.seq"
 IN1 = DATA_DIR / "input1.txt"
 OUT = OUT_DIR / "output1golden.txt"
+SIM_OUT = OUT_DIR / "output0"   # Dataout0 of aiesimulator, checked when present
 
 # Timestamp generation (ps)
 DEFAULT_START_TS = 6553600     
@@ -40,16 +44,15 @@ def read_A_packets_ignore_id(path: Path, ra: int, ca: int):
     tokens = tokenize_keep_markers(txt)
     payload_size = ra * ca
 
-    # Collect token chunks separated by TLAST if present, else do fixed-size chunking (1 + payload)
+    # Collect token chunks closed by the word after each TLAST if present, else do fixed-size chunking (1 + payload)
     chunks = []
     cur = []
     saw_tlast = False
+    closing = False
     for tok in tokens:
         if tok.upper() == "TLAST":
-            if cur:
-                chunks.append(cur)
-                cur = []
             saw_tlast = True
+            closing = True
             continue
         if tok.upper() in {"HEADER"}:
             continue
@@ -57,6 +60,10 @@ def read_A_packets_ignore_id(path: Path, ra: int, ca: int):
             cur.append(try_parse_int(tok))
         except Exception:
             continue
+        if closing:
+            chunks.append(cur)
+            cur = []
+            closing = False
 
     if cur:
         if saw_tlast:
@@ -108,17 +115,43 @@ def read_B_matrices(path: Path, rb: int, cb: int):
     return mats
 
 
+def read_result_packets(path: Path, cb: int):
+    """Column maxima of every result packet in an aiesimulator output: the
+    header, cb maxima and the TRACE_WORDS cycle stamps, TLAST before the
+    last word. The stamps differ from run to run and are skipped."""
+    packets = []
+    cur = []
+    last = False
+    for line in path.read_text().splitlines():
+        tok = line.strip()
+        if not tok or tok.startswith("T "):
+            continue
+        if tok.upper() == "TLAST":
+            last = True
+            continue
+        cur.append(try_parse_int(tok))
+        if last:
+            if len(cur) != 1 + cb + TRACE_WORDS:
+                print(f"Skipping result packet #{len(packets)} of {len(cur)} words, "
+                      f"expected {1 + cb + TRACE_WORDS}")
+            else:
+                packets.append(cur[1:1 + cb])
+            cur = []
+            last = False
+    return packets
+
+
 # ----------------- core compute -----------------
 def compute_col_maxima(A_vals, B_vals, Ra, Ca, Cb):
-    # A_vals: length Ra*Ca, B_vals: length Ca*Cb
+    # A_vals: Ra x Ca in 4x2 MMUL tiles, B_vals: Ca x Cb in 2x4 MMUL tiles,
+    # as aie_core1 reads them
     col_max = [-1e30] * Cb
     for r in range(Ra):
-        row_off = r * Ca
         for j in range(Cb):
             s = 0.0
             for k in range(Ca):
-                a = float(A_vals[row_off + k])
-                b = float(B_vals[k * Cb + j])
+                a = float(A_vals[((r // 4) * (Ca // 2) + k // 2) * 8 + (r % 4) * 2 + k % 2])
+                b = float(B_vals[((k // 2) * (Cb // 4) + j // 4) * 8 + (k % 2) * 4 + j % 4])
                 s += a * b
             if s > col_max[j]:
                 col_max[j] = s
@@ -141,9 +174,10 @@ def main():
     if not B_mats:
         raise ValueError("No valid B matrices found")
 
-    pkt_count = min(len(A_packets), len(B_mats))
-    if len(A_packets) != len(B_mats):
-        print(f"Warning: A packets ({len(A_packets)}) != B matrices ({len(B_mats)}). Using {pkt_count} packets (min).")
+    # one corpus packet per shard, all scored against the broadcast batch
+    pkt_count = len(A_packets)
+    if len(B_mats) != 1:
+        print(f"Warning: {len(B_mats)} B matrices, every packet uses the first")
 
     # Prepare base timestamps per packet
     if base_timestamps:
@@ -157,11 +191,13 @@ def main():
         # note: above makes successive packets start after previous packet's last timestamp
         # (you can adjust logic if you want different spacing)
 
+    golden = []
     with OUT.open("w") as f:
         for p in range(pkt_count):
             A = A_packets[p]
-            B = B_mats[p]
+            B = B_mats[0]
             col_max = compute_col_maxima(A, B, Ra, Ca, Cb)
+            golden.append([int(v) for v in col_max])
 
             # emit each column max then a timestamp line
             ts = bases[p]
@@ -170,15 +206,26 @@ def main():
                 f.write(f"T {ts} ps\n")
                 ts += DEFAULT_TS_STEP
 
-            # TLAST then repeat last value (to match the sample)
-            f.write("TLAST\n")
-            f.write(f"{int(col_max[-1])}\n")
+            # TLAST then repeat last value (to match the sample); with
+            # STAGE_TRACE it goes with the last cycle stamp, not written here
+            if TRACE_WORDS == 0:
+                f.write("TLAST\n")
+                f.write(f"{int(col_max[-1])}\n")
 
             # also print to stdout for debugging
-            print(f"Packet {p+1} outputs (wrote {Cb} cols + TLAST): last={int(col_max[-1])}")
+            print(f"Packet {p+1} outputs (wrote {Cb} cols): last={int(col_max[-1])}")
 
     print(f"Golden file written to {OUT} (packets: {pkt_count})")
 
+    # pktmerge interleaves the shards, so packets are matched in any order
+    if SIM_OUT.exists():
+        result = read_result_packets(SIM_OUT, Cb)
+        if sorted(result) == sorted(golden):
+            print(f"{SIM_OUT.name}: {len(result)} result packets match")
+        else:
+            print(f"{SIM_OUT.name}: result packets DO NOT match the golden")
+            raise SystemExit(1)
+
 
 if __name__ == "__main__":
     main()
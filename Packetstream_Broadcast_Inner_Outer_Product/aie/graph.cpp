@@ -14,13 +14,100 @@ limitations under the License.
 
 using namespace adf;
 
+#ifdef GMIO_INPUT
+gmioGraph gr;
+#else
 simpleGraph gr;
+#endif
+
+#ifdef GMIO_INPUT
+// Test pattern shared by the simulator main and the XRT host
+static void gmio_fill(float* corpus, int core, int floats) {
+  for (int v = 0; v < floats; v++) corpus[v] = (float)((v * 7 + core * 13) % 17) - 8.0f;
+}
+
+static void gmio_fill_query(float* query, int floats) {
+  for (int v = 0; v < floats; v++) query[v] = (float)((v * 5) % 11) - 5.0f;
+}
+
+// Scalar column max/argmax of one block, both operands in MMUL tile order
+static void golden_block(const float* A, const float* B, float* out) {
+  for (int j = 0; j < F_Cb; j++) {
+    float best = -1e30f;
+    int arg = -1;
+    for (int r = 0; r < F_Ra; r++) {
+      float v = 0.0f;
+      for (int k = 0; k < F_Ca; k++) {
+        v += A[((r / 4) * (F_Ca / 2) + k / 2) * 8 + (r % 4) * 2 + k % 2] *
+             B[((k / 2) * (F_Cb / 4) + j / 4) * 8 + (k % 2) * 4 + j % 4];
+      }
+      if (v > best) { best = v; arg = r; }
+    }
+    out[j * 2] = best;
+    out[j * 2 + 1] = (float)arg;
+  }
+}
+
+#endif
 
 #if defined(__AIESIM__) || defined(__ADF_FRONTEND__)
+#ifdef GMIO_INPUT
+#include <cmath>
+#include <iostream>
+
+int main(int argc, char ** argv) {
+  const int blockFloats = F_Ra * F_Ca;
+  const int queryFloats = F_Rb * F_Cb;
+  const int outFloats = F_Cb * 2;
+
+  float* query = (float*)GMIO::malloc(GMIO_BLOCKS * queryFloats * sizeof(float));
+  float* corpus[N];
+  float* result[N];
+  for (int i = 0; i < N; i++) {
+    corpus[i] = (float*)GMIO::malloc(GMIO_BLOCKS * blockFloats * sizeof(float));
+    result[i] = (float*)GMIO::malloc(GMIO_BLOCKS * outFloats * sizeof(float));
+    gmio_fill(corpus[i], i, GMIO_BLOCKS * blockFloats);
+  }
+  // the query batch is consumed once per block
+  gmio_fill_query(query, queryFloats);
+  for (int b = 1; b < GMIO_BLOCKS; b++)
+    for (int v = 0; v < queryFloats; v++) query[b * queryFloats + v] = query[v];
+
+  gr.init();
+  gr.g_q.gm2aie_nb(query, GMIO_BLOCKS * queryFloats * sizeof(float));
+  for (int i = 0; i < N; i++) {
+    gr.g_in[i].gm2aie_nb(corpus[i], GMIO_BLOCKS * blockFloats * sizeof(float));
+    gr.g_out[i].aie2gm_nb(result[i], GMIO_BLOCKS * outFloats * sizeof(float));
+  }
+  gr.run(GMIO_BLOCKS);
+  for (int i = 0; i < N; i++) gr.g_out[i].wait();
+  gr.end();
+
+  int errors = 0;
+  float expected[F_Cb * 2];
+  for (int i = 0; i < N; i++) {
+    for (int b = 0; b < GMIO_BLOCKS; b++) {
+      golden_block(corpus[i] + b * blockFloats, query, expected);
+      for (int v = 0; v < outFloats; v++)
+        if (std::fabs(result[i][b * outFloats + v] - expected[v]) > 1e-3f) errors++;
+    }
+    GMIO::free(corpus[i]);
+    GMIO::free(result[i]);
+  }
+  GMIO::free(query);
+
+  std::cout << "GMIO TEST " << (errors ? "FAILED" : "PASSED") << std::endl;
+  return errors ? 1 : 0;
+}
+#else
 int main(int argc, char ** argv) {
   gr.init();
+#ifdef THRESHOLD_EMIT
+  gr.update(gr.min_score, THRESHOLD_MIN_SCORE);
+#endif
   gr.run(1);
   gr.end();
   return 0;
 }
 #endif
+#endif
@@ -5,57 +5,241 @@
 #include "kernels.h"
 #include <string.h>
 
+#include "placement.h"
+
 #define N 6
-#define MAXROW 8
 
-using namespace adf;
+// #define BINARY_PREFILTER
+// #define GMIO_INPUT
+// #define THRESHOLD_EMIT
+// #define ATTRIBUTE_FILTER
+// #define WIDE_INGEST
+// #define OUTER_PRODUCT
 
-class simpleGraph : public graph {
-private:
-    kernel core[N];
-    pktsplit<N> sp;         
+using namespace adf;
 
+// NSHARDS corpus shards, one core each. Shards are split into pktsplit
+// groups of at most PKTSPLIT_MAX, GROUP wide except for a possibly smaller
+// last group of LAST shards; every group has its own corpus PLIO
+// (Datain<g>, data/input<g>.seq) and the query batch is broadcast to all
+// cores from one PLIO. The result packets of a group are combined by a
+// pktmerge onto one PLIO (Dataout<g>), each packet still carrying the
+// packet id of its shard, which hls_packet_receiver maps back to the shard.
+// Placement comes from ShardPlacement.
+// WIDE_INGEST widens the PLIOs to 128 bits and gives every group a second
+// corpus PLIO (Dataodd<g>) with its own pktsplit, so each core reads the
+// even rows of its block on in[0] and the odd rows on in[1].
+#ifdef WIDE_INGEST
+#define SHARD_PLIO_WIDTH plio_128_bits
+#else
+#define SHARD_PLIO_WIDTH plio_32_bits
+#endif
+
+template <int NSHARDS>
+class shardedGraph : public graph {
 public:
+    static constexpr int NGROUPS = ShardPlacement::groups(NSHARDS);
+    static constexpr int GROUP = ShardPlacement::group_size(NSHARDS);
+    static constexpr int LAST = ShardPlacement::last_group_size(NSHARDS);
+    static constexpr int NFULL = NGROUPS - 1;
 
-    input_plio p_s0;                     
-    input_plio p_s1;                       
-    output_plio p_s2_0, p_s2_1, p_s2_2, p_s2_3, p_s2_4, p_s2_5;
+private:
+    kernel core[NSHARDS];
+    // groups 0 .. NFULL - 1, then the last group
+    pktsplit<GROUP> sp[NFULL > 0 ? NFULL : 1];
+    pktmerge<GROUP> mg[NFULL > 0 ? NFULL : 1];
+    pktsplit<LAST> sp_last;
+    pktmerge<LAST> mg_last;
+#ifdef WIDE_INGEST
+    pktsplit<GROUP> sp_odd[NFULL > 0 ? NFULL : 1];
+    pktsplit<LAST> sp_odd_last;
+#endif
+#ifdef BINARY_PREFILTER
+    kernel rerank;
+#endif
 
-    simpleGraph() {
-        int col = 1;
-        output_plio* p_s2_list[N] = {&p_s2_0, &p_s2_1, &p_s2_2, &p_s2_3, &p_s2_4, &p_s2_5};
+public:
 
-        
-        p_s0 = input_plio::create("StreamIn0", plio_32_bits, "data/input0.seq");
+    input_plio p_s0[NGROUPS];
+    input_plio p_s1;
+    output_plio p_s2[NGROUPS];
+#ifdef WIDE_INGEST
+    input_plio p_odd[NGROUPS];
+#endif
+#ifdef THRESHOLD_EMIT
+    // runtime parameter shared by all shards: minimum score to emit
+    port<input> min_score;
+#endif
+#ifdef BINARY_PREFILTER
+    input_plio p_rr0;
+    input_plio p_rr1;
+    output_plio p_rr2;
+#endif
+
+    shardedGraph() {
+        static_assert(ShardPlacement::columns(NSHARDS) <= AIE_COLS, "more shards than tiles");
+
+        for (int g = 0; g < NGROUPS; g++) {
+            char name[30];
+            char file[40];
+            sprintf(name, "Datain%d", g);
+#ifdef BINARY_PREFILTER
+            if (g) sprintf(file, "data/bin_codes%d.seq", g);
+            else sprintf(file, "data/bin_codes.seq");
+#elif defined(ATTRIBUTE_FILTER)
+            sprintf(file, "data/filter_input%d.seq", g);
+#elif defined(WIDE_INGEST)
+            sprintf(file, "data/wide_even%d.seq", g);
+#elif defined(OUTER_PRODUCT)
+            sprintf(file, "data/qv_input%d.seq", g);
+#else
+            sprintf(file, "data/input%d.seq", g);
+#endif
+            p_s0[g] = input_plio::create(name, SHARD_PLIO_WIDTH, file);
+#ifdef WIDE_INGEST
+            sprintf(name, "Dataodd%d", g);
+            sprintf(file, "data/wide_odd%d.seq", g);
+            p_odd[g] = input_plio::create(name, SHARD_PLIO_WIDTH, file);
+#endif
+
+            sprintf(name, "Dataout%d", g);
+            sprintf(file, "output%d", g);
+            p_s2[g] = output_plio::create(name, plio_32_bits, file);
+        }
+#ifdef BINARY_PREFILTER
+        p_s1 = input_plio::create("StreamIn1_broadcast", plio_32_bits, "data/bin_queries.txt");
+#elif defined(ATTRIBUTE_FILTER)
+        p_s1 = input_plio::create("StreamIn1_broadcast", plio_32_bits, "data/filter_queries.txt");
+#elif defined(WIDE_INGEST)
+        p_s1 = input_plio::create("StreamIn1_broadcast", plio_128_bits, "data/wide_queries.txt");
+#elif defined(OUTER_PRODUCT)
+        p_s1 = input_plio::create("StreamIn1_broadcast", plio_32_bits, "data/qv_queries.txt");
+#else
         p_s1 = input_plio::create("StreamIn1_broadcast", plio_32_bits, "data/input1.txt");
-
-        for (int i = 0; i < N; i++) {
-            char out_file_str[30];
-            sprintf(out_file_str, "output%d", i);
-            char p2_name[30];
-            sprintf(p2_name, "StreamOut0_%d", i);
-
-            *p_s2_list[i] = output_plio::create(p2_name, plio_32_bits, out_file_str);
-
+#endif
+
+        for (int i = 0; i < NSHARDS; i++) {
+#ifdef BINARY_PREFILTER
+            core[i] = kernel::create(aie_hamming_prefilter);
+            source(core[i]) = "aie_hamming.cpp";
+#elif defined(THRESHOLD_EMIT)
+            core[i] = kernel::create(aie_core1_threshold);
+            source(core[i]) = "aie_core1.cpp";
+            connect<parameter>(min_score, async(core[i].in[2]));
+#elif defined(ATTRIBUTE_FILTER)
+            core[i] = kernel::create(aie_core1_filtered);
+            source(core[i]) = "aie_core1.cpp";
+#elif defined(WIDE_INGEST)
+            core[i] = kernel::create(aie_core1_dual);
+            source(core[i]) = "aie_core1.cpp";
+#elif defined(OUTER_PRODUCT)
+            core[i] = kernel::create(aie_core1_outer);
+            source(core[i]) = "aie_core1.cpp";
+#else
             core[i] = kernel::create(aie_core1);
             source(core[i]) = "aie_core1.cpp";
+#endif
             runtime<ratio>(core[i]) = 1;
-            col = (i / MAXROW) * 10;
-            location<kernel>(core[i]) = tile(col, i % MAXROW);
+            location<kernel>(core[i]) = tile(ShardPlacement::col(NSHARDS, i), ShardPlacement::row(i));
+        }
 
+        for (int g = 0; g < NFULL; g++) {
+#ifdef WIDE_INGEST
+            connect_group(g, sp[g], mg[g], sp_odd[g]);
+#else
+            connect_group(g, sp[g], mg[g]);
+#endif
+        }
+#ifdef WIDE_INGEST
+        connect_group(NFULL, sp_last, mg_last, sp_odd_last);
+#else
+        connect_group(NFULL, sp_last, mg_last);
+#endif
+
+#ifdef WIDE_INGEST
+        const int query_port = 2;
+#else
+        const int query_port = 1;
+#endif
+        for (int i = 0; i < NSHARDS; ++i) {
+            connect<stream>(p_s1.out[0], core[i].in[query_port]);
+        }
 
-            connect<pktstream>(core[i].out[0], (*p_s2_list[i]).in[0]);
+#ifdef BINARY_PREFILTER
+        // second pass: host gathers the float rows of each query's candidates
+        static_assert(BIN_TOPR * NSHARDS <= RR_ROWS, "a query's candidates must fit one rerank packet");
+        p_rr0 = input_plio::create("RerankIn0", plio_32_bits, "data/rerank_candidates.seq");
+        p_rr1 = input_plio::create("RerankIn1", plio_32_bits, "data/rerank_queries.txt");
+        p_rr2 = output_plio::create("RerankOut0", plio_32_bits, "rerank_output");
+
+        rerank = kernel::create(aie_rerank);
+        source(rerank) = "aie_core1.cpp";
+        runtime<ratio>(rerank) = 1;
+
+        connect<pktstream>(p_rr0.out[0], rerank.in[0]);
+        connect<stream>(p_rr1.out[0], rerank.in[1]);
+        connect<pktstream>(rerank.out[0], p_rr2.in[0]);
+#endif
+    }
+
+private:
+    // pktsplit and pktmerge of group g, W shards from core[g * GROUP] on;
+    // packet id k of the group is shard g * GROUP + k
+    template <int W>
+    void connect_group(int g, pktsplit<W>& split, pktmerge<W>& merge
+#ifdef WIDE_INGEST
+                       , pktsplit<W>& split_odd
+#endif
+                       ) {
+        split = pktsplit<W>::create();
+        merge = pktmerge<W>::create();
+        connect<pktstream>(p_s0[g].out[0], split.in[0]);
+        for (int k = 0; k < W; k++) {
+            connect<pktstream>(split.out[k], core[g * GROUP + k].in[0]);
+            connect<pktstream>(core[g * GROUP + k].out[0], merge.in[k]);
         }
+        connect<pktstream>(merge.out[0], p_s2[g].in[0]);
+#ifdef WIDE_INGEST
+        split_odd = pktsplit<W>::create();
+        connect<pktstream>(p_odd[g].out[0], split_odd.in[0]);
+        for (int k = 0; k < W; k++)
+            connect<pktstream>(split_odd.out[k], core[g * GROUP + k].in[1]);
+#endif
+    }
+};
 
-        sp = pktsplit<N>::create();
+typedef shardedGraph<N> simpleGraph;
+
+// GMIO variant: no PL movers. Every core DMAs its corpus blocks from DDR
+// through its own input_gmio, the query batch is one broadcast input_gmio
+// and each core writes its (score, row) pairs back through an output_gmio.
+class gmioGraph : public graph {
+private:
+    kernel core[N];
+
+public:
+    input_gmio g_in[N];
+    input_gmio g_q;
+    output_gmio g_out[N];
+
+    gmioGraph() {
+        g_q = input_gmio::create("GmioQuery", GMIO_BURST, GMIO_BANDWIDTH);
 
-        connect<pktstream>(p_s0.out[0], sp.in[0]);
         for (int i = 0; i < N; i++) {
-            connect<pktstream>(sp.out[i], core[i].in[0]);
-        }
+            char name[30];
+            sprintf(name, "GmioIn%d", i);
+            g_in[i] = input_gmio::create(name, GMIO_BURST, GMIO_BANDWIDTH);
+            sprintf(name, "GmioOut%d", i);
+            g_out[i] = output_gmio::create(name, GMIO_BURST, GMIO_BANDWIDTH);
+
+            core[i] = kernel::create(aie_core1_gmio);
+            source(core[i]) = "aie_core1.cpp";
+            runtime<ratio>(core[i]) = 1;
+            location<kernel>(core[i]) = tile(ShardPlacement::col(N, i), ShardPlacement::row(i));
 
-        for (int i = 0; i < N; ++i) {
-            connect<stream>(p_s1.out[0], core[i].in[1]);
+            connect(g_in[i].out[0], core[i].in[0]);
+            connect(g_q.out[0], core[i].in[1]);
+            connect(core[i].out[0], g_out[i].in[0]);
         }
     }
 };
@@ -14,8 +14,34 @@ limitations under the License.
 #define __KERNELS_H__
 
 #include <adf.h>
+#include "system_settings.h"
 
 // Kernel interface aligned with existing graph: pktstream A, stream B, pktstream out
 void aie_core1(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out);
 
+// Attribute filter mode: per-row attribute words and per-query masks follow
+// the corpus block and the query batch
+void aie_core1_filtered(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out);
+
+// Threshold mode: only (score, id) pairs above min_score, variable-length packets
+void aie_core1_threshold(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out, int32 min_score);
+
+// Binary mode: sign-bit Hamming prefilter (pktstream codes, broadcast query
+// codes) and the float rerank of each query's gathered candidates
+void aie_hamming_prefilter(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out);
+void aie_rerank(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out);
+
+// Wide ingest mode: even rows of the corpus block on in0, odd rows on in1,
+// query batch on the 128-bit broadcast stream in2
+void aie_core1_dual(input_pktstream *in0, input_pktstream *in1, input_stream<int32> *in2, output_pktstream *out);
+
+// Outer-product mode: k-blocks of the queries on in1 and of the corpus
+// vectors on in0, accumulated over the whole embedding
+void aie_core1_outer(input_pktstream *in0, input_stream<int32> *in1, output_pktstream *out);
+
+// GMIO mode: corpus block and query batch DMA'd from DDR into tile buffers
+void aie_core1_gmio(adf::input_async_buffer<float, adf::extents<F_Ra * F_Ca>>& in0,
+                    adf::input_buffer_1d<float, F_Rb * F_Cb>& in1,
+                    adf::output_buffer_1d<float, F_Cb * 2>& out);
+
 #endif
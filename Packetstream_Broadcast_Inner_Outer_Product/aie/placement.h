@@ -0,0 +1,38 @@
+#ifndef _PLACEMENT_H_
+#define _PLACEMENT_H_
+
+// Shard placement for the packet-switched graphs. Shards fill one column of
+// MAXROW tiles after the other; the rows snake (down one column, up the
+// next) so consecutive shards of a pktsplit group stay neighbours across
+// column boundaries. Shard columns are spread evenly over the array, at most
+// MAX_COL_STRIDE apart, which leaves the columns in between free for the
+// ping-pong buffers and the stream routes of the broadcast and merge paths.
+
+#define AIE_COLS 50             // VC1902 array
+#define MAXROW 8
+#define MAX_COL_STRIDE 10
+#define PKTSPLIT_MAX 32         // 5-bit packet id per pktsplit
+
+struct ShardPlacement {
+    // pktsplit groups needed for n shards, each on its own input PLIO
+    static constexpr int groups(int n) { return (n + PKTSPLIT_MAX - 1) / PKTSPLIT_MAX; }
+
+    // shards per group; the last group takes what is left, which may be fewer
+    static constexpr int group_size(int n) { return (n + groups(n) - 1) / groups(n); }
+    static constexpr int last_group_size(int n) { return n - (groups(n) - 1) * group_size(n); }
+    static constexpr int group_size(int n, int g) { return g == groups(n) - 1 ? last_group_size(n) : group_size(n); }
+
+    static constexpr int columns(int n) { return (n + MAXROW - 1) / MAXROW; }
+
+    static constexpr int col_stride(int n) {
+        return AIE_COLS / columns(n) < MAX_COL_STRIDE ? AIE_COLS / columns(n) : MAX_COL_STRIDE;
+    }
+
+    static constexpr int col(int n, int i) { return (i / MAXROW) * col_stride(n); }
+
+    static constexpr int row(int i) {
+        return (i / MAXROW) % 2 ? MAXROW - 1 - i % MAXROW : i % MAXROW;
+    }
+};
+
+#endif
@@ -8,3 +8,56 @@
 #define F_Cb 32
 #define F_Rc (F_Ra)
 #define F_Cc (F_Cb)
+
+// Binary (sign-bit) prefilter: one bit per dimension, BIN_WORDS words per
+// vector. The rerank stage scores in float and holds the whole embedding of
+// every candidate in one tile, so BIN_DIM follows F_Ca.
+#define BIN_DIM (F_Ca)
+#define BIN_WORDS (BIN_DIM / 32)
+#define BIN_ROWS 4096           // corpus codes per packet
+#define BIN_TOPR 16             // candidates kept per query and shard
+// Rerank: per query one packet of a live-row count and RR_ROWS candidate
+// rows, which holds the BIN_TOPR candidates of every shard; RR_TOPK exact
+// results are kept
+#define RR_ROWS (F_Ra)
+#define RR_TOPK 10
+
+// GMIO mode: corpus blocks are DMA'd from DDR by the tiles. Burst length in
+// bytes and requested bandwidth in MB/s per GMIO port.
+#define GMIO_BURST 64
+#define GMIO_BANDWIDTH 1000
+#define GMIO_BLOCKS 4           // corpus blocks per core and graph run
+
+// Threshold mode: a result packet holds at most one (score, id) pair per
+// query plus the closing hit count
+#define HIT_MAX_WORDS (2 * F_Cb + 1)
+#define THRESHOLD_MIN_SCORE 0
+
+// Stage trace: with STAGE_TRACE, every kernel feeding hls_packet_receiver
+// (aie_core1 and its _dual, _filtered and _outer forms) closes its result
+// packet with TRACE_WORDS words, the low 32 bits of the tile cycle counter
+// at kernel entry and at exit. The receiver includes this file too, so both
+// sides agree on the packet length. The host turns the stamps into time at
+// AIE_CLOCK_MHZ (sw/stage_trace.h). Off by default; uncomment for a trace
+// build of the graph, the PL kernels and the host.
+// #define STAGE_TRACE
+#ifdef STAGE_TRACE
+#define TRACE_WORDS 2
+#else
+#define TRACE_WORDS 0
+#endif
+#define AIE_CLOCK_MHZ 1250
+
+// Wide ingest mode: 128-bit PLIOs, every shard tile takes its corpus block
+// on two pktstreams, even rows on one and odd rows on the other. Each
+// stream carries half the block, padded to whole 128-bit beats.
+#define WIDE_HALF_WORDS (F_Ra * F_Ca / 2)
+#define WIDE_PKT_PAD 3          // header + WIDE_HALF_WORDS + pad = 4k words
+
+// Outer-product mode: OP_Ra queries (broadcast) against OP_Cb corpus
+// vectors per packet, the OP_DIM-long embeddings streamed OP_KB dimensions
+// at a time. Tile memory is C plus one k-block, independent of OP_DIM.
+#define OP_Ra (F_Cb)
+#define OP_Cb 32
+#define OP_KB 8
+#define OP_DIM 256
@@ -8,6 +8,10 @@ SEQ_COLS = 32
 TXT_ROWS = SEQ_COLS
 TXT_COLS = 32
 
+# must match N in aie/graph.h and PKTSPLIT_MAX in aie/placement.h
+NUM_SHARDS = 6
+PKTSPLIT_MAX = 32
+
 def gen_input0_txt(path, seed=0):
 	"""Generate plain text file for one 32x32 matrix, row-major, one value per line."""
 	rng = np.random.default_rng(seed)
@@ -56,6 +60,19 @@ def gen_input1_txt(path, seed=3):
 		for v in B:
 			f.write(f"{int(v)}\n")
 
+def num_groups(shards):
+	"""pktsplit groups of shardedGraph, one input<g>.seq each"""
+	return (shards + PKTSPLIT_MAX - 1) // PKTSPLIT_MAX
+
+def group_shards(shards, g):
+	"""shards of pktsplit group g as ShardPlacement groups them: group_size
+	each, the last group takes what is left"""
+	groups = num_groups(shards)
+	size = (shards + groups - 1) // groups
+	return range(g * size, min(shards, (g + 1) * size))
+
 if __name__ == "__main__":
-	gen_input0_seq("data/input0.seq", num_packets=6)
+	groups = num_groups(NUM_SHARDS)
+	for g in range(groups):
+		gen_input0_seq(f"data/input{g}.seq", num_packets=len(group_shards(NUM_SHARDS, g)), seed=2 + g)
 	gen_input1_txt("data/input1.txt")
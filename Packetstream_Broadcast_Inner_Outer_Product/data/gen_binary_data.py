@@ -0,0 +1,107 @@
+import struct
+import numpy as np
+from pathlib import Path
+
+# this is for the binary prefilter + float rerank mode (BINARY_PREFILTER)
+
+# ---------- must match aie/system_settings.h and graph.h ----------
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+BIN_DIM = F_Ca
+BIN_WORDS = BIN_DIM // 32
+BIN_ROWS = 4096
+BIN_TOPR = 16
+RR_ROWS = F_Ra
+RR_TOPK = 10
+NUM_CORES = 6
+
+out_dir = Path(__file__).parent
+CODES_SEQ = out_dir / "bin_codes.seq"
+QUERIES_TXT = out_dir / "bin_queries.txt"
+GOLDEN_TXT = out_dir / "bin_golden.txt"
+RR_CANDIDATES_SEQ = out_dir / "rerank_candidates.seq"
+RR_QUERIES_TXT = out_dir / "rerank_queries.txt"
+RR_GOLDEN_TXT = out_dir / "rerank_golden.txt"
+
+
+def sign_codes(x: np.ndarray) -> np.ndarray:
+    """Bit d of word w is set when dimension 32*w + d is positive"""
+    bits = (x > 0).astype(np.uint64).reshape(x.shape[0], BIN_WORDS, 32)
+    words = (bits << np.arange(32, dtype=np.uint64)).sum(axis=2)
+    return words.astype(np.uint32).view(np.int32)
+
+
+def hamming(a: np.ndarray, b: np.ndarray) -> np.ndarray:
+    """Distance of every row of a to every row of b"""
+    x = np.bitwise_xor(a.view(np.uint32)[:, None, :], b.view(np.uint32)[None, :, :])
+    return np.unpackbits(x.view(np.uint8), axis=2).sum(axis=2)
+
+
+def float_bits(v) -> int:
+    return struct.unpack("<i", struct.pack("<f", np.float32(v)))[0]
+
+
+def write_packets(path: Path, payloads, header_base: int):
+    with path.open("w") as f:
+        for p, words in enumerate(payloads):
+            f.write(f"{header_base + p}\n")
+            for v in words[:-1]:
+                f.write(f"{int(v)}\n")
+            f.write("TLAST\n")
+            f.write(f"{int(words[-1])}\n")
+
+
+def main():
+    rng = np.random.default_rng(4)
+    corpus = rng.standard_normal((NUM_CORES * BIN_ROWS, BIN_DIM)).astype(np.float32)
+    queries = rng.standard_normal((F_Cb, BIN_DIM)).astype(np.float32)
+    ccodes = sign_codes(corpus)
+    qcodes = sign_codes(queries)
+
+    # ---- first pass: one packet of codes per core ----
+    write_packets(CODES_SEQ, [ccodes[c * BIN_ROWS:(c + 1) * BIN_ROWS].reshape(-1)
+                              for c in range(NUM_CORES)], 3415853568)
+    with QUERIES_TXT.open("w") as f:
+        for v in qcodes.reshape(-1):
+            f.write(f"{int(v)}\n")
+
+    candidates = [[] for _ in range(F_Cb)]
+    with GOLDEN_TXT.open("w") as f:
+        for c in range(NUM_CORES):
+            shard = ccodes[c * BIN_ROWS:(c + 1) * BIN_ROWS]
+            dist = hamming(qcodes, shard)                   # F_Cb x BIN_ROWS
+            for q in range(F_Cb):
+                order = np.argsort(dist[q], kind='stable')[:BIN_TOPR]
+                for r in order:
+                    f.write(f"{int(dist[q, r])}\n{int(r)}\n")
+                    candidates[q].append(c * BIN_ROWS + int(r))
+
+    # ---- second pass: per query one packet with the live-row count and
+    # the float rows of its BIN_TOPR candidates from every shard, zero rows
+    # as padding; padding is never scored ----
+    assert NUM_CORES * BIN_TOPR <= RR_ROWS
+    packets = []
+    with RR_GOLDEN_TXT.open("w") as f:
+        for q in range(F_Cb):
+            live = len(candidates[q])
+            a = np.zeros((RR_ROWS, F_Ca), dtype=np.float32)
+            a[:live] = corpus[candidates[q]]
+            packets.append([live] + [float_bits(v) for v in a.reshape(-1)])
+            scores = a[:live] @ queries[q]
+            top = list(np.argsort(-scores, kind='stable')[:RR_TOPK])
+            for slot in top:
+                f.write(f"{float_bits(scores[slot])}\n{int(slot)}\n")
+            for _ in range(RR_TOPK - len(top)):
+                f.write(f"{float_bits(-1e30)}\n-1\n")
+    write_packets(RR_CANDIDATES_SEQ, packets, 2415853568)
+    with RR_QUERIES_TXT.open("w") as f:
+        for v in queries.reshape(-1):
+            f.write(f"{float_bits(v)}\n")
+
+    print(f"Wrote {CODES_SEQ.name}, {QUERIES_TXT.name}, {RR_CANDIDATES_SEQ.name}, "
+          f"{RR_QUERIES_TXT.name} and goldens ({F_Cb} rerank packets)")
+
+
+if __name__ == "__main__":
+    main()
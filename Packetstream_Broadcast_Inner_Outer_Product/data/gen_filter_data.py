@@ -0,0 +1,82 @@
+import numpy as np
+from pathlib import Path
+
+# this is for the attribute filter mode (ATTRIBUTE_FILTER)
+
+# ---------- must match aie/system_settings.h and graph.h ----------
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+NUM_SHARDS = 6
+PKTSPLIT_MAX = 32
+
+# Attribute words: bit 31 marks a real corpus row, the low ATTR_BITS bits are
+# tags (tenant, document type, ...). A row passes a query when it carries
+# every bit of the query mask; masks always include ATTR_VALID.
+ATTR_VALID = 1 << 31
+ATTR_BITS = 4
+INT32_MIN = -(1 << 31)
+
+out_dir = Path(__file__).parent
+QUERIES_TXT = out_dir / "filter_queries.txt"
+GOLDEN_TXT = out_dir / "filter_golden.txt"
+
+
+def tile(mat: np.ndarray, R: int, C: int) -> np.ndarray:
+    """Row-major -> R x C block order (write_file.py::mat2file_tile)"""
+    rows, cols = mat.shape
+    t = mat.reshape(rows // R, R, cols // C, C).transpose(0, 2, 1, 3)
+    return t.reshape(-1)
+
+
+def as_int32(words: np.ndarray) -> np.ndarray:
+    return words.astype(np.uint32).view(np.int32)
+
+
+def write_packets(path: Path, payloads, header_base: int):
+    with path.open("w") as f:
+        for p, words in enumerate(payloads):
+            f.write(f"{header_base + p}\n")
+            for v in words[:-1]:
+                f.write(f"{int(v)}\n")
+            f.write("TLAST\n")
+            f.write(f"{int(words[-1])}\n")
+
+
+def main():
+    rng = np.random.default_rng(5)
+    groups = (NUM_SHARDS + PKTSPLIT_MAX - 1) // PKTSPLIT_MAX
+    group = (NUM_SHARDS + groups - 1) // groups    # the last group takes what is left
+
+    a = rng.integers(0, 10, size=(NUM_SHARDS, F_Ra, F_Ca))
+    attrs = ATTR_VALID | rng.integers(0, 1 << ATTR_BITS, size=(NUM_SHARDS, F_Ra))
+    b = rng.integers(1, 5, size=(F_Ca, F_Cb))
+    # one or two required tags per query, a few unfiltered queries
+    masks = ATTR_VALID | (rng.integers(0, 1 << ATTR_BITS, size=F_Cb) & rng.integers(0, 1 << ATTR_BITS, size=F_Cb))
+
+    for g in range(groups):
+        shards = range(g * group, min(NUM_SHARDS, (g + 1) * group))
+        write_packets(out_dir / f"filter_input{g}.seq",
+                      [np.concatenate([tile(a[s], 4, 2), as_int32(attrs[s])]) for s in shards],
+                      3415853568)
+    with QUERIES_TXT.open("w") as f:
+        for v in np.concatenate([tile(b, 2, 4), as_int32(masks)]):
+            f.write(f"{int(v)}\n")
+
+    # per shard, what aie_core1_filtered writes: the best passing score of
+    # every query, INT32_MIN when no row of the shard passes
+    with GOLDEN_TXT.open("w") as f:
+        for s in range(NUM_SHARDS):
+            scores = a[s] @ b
+            passes = (attrs[s][:, None] & masks[None, :]) == masks[None, :]
+            best = np.where(passes, scores, INT32_MIN).max(axis=0)
+            for v in best:
+                f.write(f"{int(v)}\n")
+
+    selectivity = ((attrs[:, :, None] & masks) == masks).mean()
+    print(f"Wrote {groups} filter_input<g>.seq, {QUERIES_TXT.name} and {GOLDEN_TXT.name} "
+          f"(selectivity {selectivity:.2f})")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,65 +1,80 @@
 import numpy as np
 from pathlib import Path
 
-# this is for the outerproduct data flow 
+# this is for the outerproduct data flow (OUTER_PRODUCT)
 
-Ra = 4   
-Ca = 16  
-Rb = 16  
-Cb = 4   
+# ---------- must match aie/system_settings.h and graph.h ----------
+Ra = 32        # OP_Ra queries
+Cb = 32        # OP_Cb corpus vectors per packet
+DIM = 256      # OP_DIM
+NUM_SHARDS = 6
+PKTSPLIT_MAX = 32
 
 out_dir = Path(__file__).parent
-INPUT0_SEQ = out_dir / "input0.seq"   # pktstream sequence (pktsplit to 3 kernels)
-INPUT1_TXT = out_dir / "input1.txt"   # broadcast stream payload (shared across 3 kernels)
+QUERIES_TXT = out_dir / "qv_queries.txt"   # broadcast stream payload
+GOLDEN_TXT = out_dir / "qv_golden.txt"
 
 # RNG seeds for reproducibility
 SEED_Q = 100
 SEED_V = 200
 
 
-def generate_Q_broadcast_columns(path: Path, seed: int = SEED_Q):
+def generate_Q_broadcast_columns(path: Path, Q: np.ndarray):
     """
-    Generate broadcast stream payload for Q:
-    Order: for k = 0..Ca-1, write 32 int values representing Q[0..31, k].
+    Broadcast stream payload for Q:
+    Order: for k = 0..DIM-1, write the Ra values Q[0..Ra-1, k].
     No headers; plain text, one value per line.
     """
-    rng = np.random.default_rng(seed)
-    # Q as integers to match kernel's int32 input, range 0..9
-    Q = rng.integers(low=0, high=10, size=(Ra, Ca), endpoint=False, dtype=np.int32)
     with path.open("w") as f:
-        for k in range(Ca):
+        for k in range(DIM):
             for r in range(Ra):
                 f.write(f"{int(Q[r, k])}\n")
 
 
-def generate_V_packets_seq(path: Path, num_packets: int = 3, seed: int = SEED_V, header_base: int = 0xCAFEB000):
+def generate_V_packets_seq(path: Path, shards, header_base: int = 0xCAFEB000):
     """
-    Generate pktstream sequence file for V rows:
-    Format: single packet -> header, then (Rb*Cb - 1) payloads, TLAST, final payload.
-    Order: for k = 0..Rb-1, write 32 int values representing V[k, 0..31].
+    pktstream sequence file, one packet per shard:
+    header, then (DIM*Cb - 1) payloads, TLAST, final payload.
+    Order: for k = 0..DIM-1, write the Cb values V[k, 0..Cb-1].
     """
     with path.open("w") as f:
-        for p in range(num_packets):
-            rng = np.random.default_rng(seed + p)
-            V = rng.integers(low=0, high=10, size=(Rb, Cb), endpoint=False, dtype=np.int32)
-            header = header_base + p
-            f.write(f"{header}\n")
-            # Write all but last payload for this packet
-            total = Rb * Cb
-            count = 0
-            for k in range(Rb):
-                for j in range(Cb):
-                    if count < total - 1:
-                        f.write(f"{int(V[k, j])}\n")
-                    count += 1
-            # TLAST then final payload value for this packet
+        for p, V in enumerate(shards):
+            f.write(f"{header_base + p}\n")
+            words = V.reshape(-1)
+            for v in words[:-1]:
+                f.write(f"{int(v)}\n")
             f.write("TLAST\n")
-            f.write(f"{int(V[Rb-1, Cb-1])}\n")
+            f.write(f"{int(words[-1])}\n")
+
+
+def num_groups(shards):
+    """pktsplit groups of shardedGraph, one qv_input<g>.seq each"""
+    return (shards + PKTSPLIT_MAX - 1) // PKTSPLIT_MAX
+
+
+def group_shards(shards, g):
+    """shards of pktsplit group g as ShardPlacement groups them: group_size
+    each, the last group takes what is left"""
+    groups = num_groups(shards)
+    size = (shards + groups - 1) // groups
+    return range(g * size, min(shards, (g + 1) * size))
 
 
 if __name__ == "__main__":
+    # integers as the kernel's int32 input, range 0..9
+    Q = np.random.default_rng(SEED_Q).integers(0, 10, size=(Ra, DIM), dtype=np.int32)
+    V = [np.random.default_rng(SEED_V + s).integers(0, 10, size=(DIM, Cb), dtype=np.int32)
+         for s in range(NUM_SHARDS)]
+
+    generate_Q_broadcast_columns(QUERIES_TXT, Q)
+    groups = num_groups(NUM_SHARDS)
+    for g in range(groups):
+        generate_V_packets_seq(out_dir / f"qv_input{g}.seq", [V[s] for s in group_shards(NUM_SHARDS, g)])
+
+    # per shard and query the row maximum of Q x V, as aie_core1_outer emits it
+    with GOLDEN_TXT.open("w") as f:
+        for s in range(NUM_SHARDS):
+            for v in (Q.astype(np.int64) @ V[s]).max(axis=1):
+                f.write(f"{int(v)}\n")
 
-    generate_Q_broadcast_columns(INPUT1_TXT)
-    generate_V_packets_seq(INPUT0_SEQ, num_packets=3)
-    print(f"Wrote: {INPUT1_TXT}")
-    print(f"Wrote: {INPUT0_SEQ}")
+    print(f"Wrote {QUERIES_TXT.name}, qv_input*.seq for {groups} group(s) and {GOLDEN_TXT.name}")
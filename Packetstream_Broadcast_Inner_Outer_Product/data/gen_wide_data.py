@@ -0,0 +1,90 @@
+import numpy as np
+from pathlib import Path
+
+# this is for the dual-port 128-bit ingest mode (WIDE_INGEST)
+
+# ---------- must match aie/system_settings.h and graph.h ----------
+F_Ra = 128
+F_Ca = 32
+F_Cb = 32
+NUM_SHARDS = 6
+PKTSPLIT_MAX = 32
+WIDE_PKT_PAD = 3
+BEAT = 4                # int32 words per 128-bit PLIO beat
+
+# positions inside one 8-word 4x2 MMUL tile carried by each port, in the
+# order aie_core1_dual reads them
+EVEN_SLOTS = [0, 1, 4, 5]   # rows 0 and 2
+ODD_SLOTS = [2, 3, 6, 7]    # rows 1 and 3
+
+out_dir = Path(__file__).parent
+QUERIES_TXT = out_dir / "wide_queries.txt"
+GOLDEN_TXT = out_dir / "wide_golden.txt"
+
+
+def tile(mat: np.ndarray, R: int, C: int) -> np.ndarray:
+    """Row-major -> R x C block order (write_file.py::mat2file_tile)"""
+    rows, cols = mat.shape
+    t = mat.reshape(rows // R, R, cols // C, C).transpose(0, 2, 1, 3)
+    return t.reshape(-1)
+
+
+def write_beats(f, words):
+    for b in range(0, len(words), BEAT):
+        f.write(" ".join(str(int(v)) for v in words[b:b + BEAT]) + "\n")
+
+
+def write_packets(path: Path, payloads, header_base: int):
+    """One packet per payload: header, payload and pad words, BEAT per line,
+    TLAST before the last beat"""
+    with path.open("w") as f:
+        for p, payload in enumerate(payloads):
+            words = [header_base + p] + [int(v) for v in payload] + [0] * WIDE_PKT_PAD
+            assert len(words) % BEAT == 0
+            write_beats(f, words[:-BEAT])
+            f.write("TLAST\n")
+            write_beats(f, words[-BEAT:])
+
+
+def num_groups(shards):
+    """pktsplit groups of shardedGraph, one wide_even<g>/wide_odd<g> pair each"""
+    return (shards + PKTSPLIT_MAX - 1) // PKTSPLIT_MAX
+
+
+def group_shards(shards, g):
+    """shards of pktsplit group g as ShardPlacement groups them: group_size
+    each, the last group takes what is left"""
+    groups = num_groups(shards)
+    size = (shards + groups - 1) // groups
+    return range(g * size, min(shards, (g + 1) * size))
+
+
+def main():
+    rng = np.random.default_rng(7)
+    corpus = rng.integers(0, 10, size=(NUM_SHARDS, F_Ra, F_Ca))
+    queries = rng.integers(1, 5, size=(F_Ca, F_Cb))
+
+    groups = num_groups(NUM_SHARDS)
+    for g in range(groups):
+        even, odd = [], []
+        for s in group_shards(NUM_SHARDS, g):
+            t = tile(corpus[s], 4, 2).reshape(-1, 8)
+            even.append(t[:, EVEN_SLOTS].reshape(-1))
+            odd.append(t[:, ODD_SLOTS].reshape(-1))
+        write_packets(out_dir / f"wide_even{g}.seq", even, 3415853568)
+        write_packets(out_dir / f"wide_odd{g}.seq", odd, 3415853568)
+
+    with QUERIES_TXT.open("w") as f:
+        write_beats(f, tile(queries, 2, 4))
+
+    # per shard the column max of A x B, as aie_core1_dual emits it
+    with GOLDEN_TXT.open("w") as f:
+        for s in range(NUM_SHARDS):
+            for v in (corpus[s] @ queries).max(axis=0):
+                f.write(f"{int(v)}\n")
+
+    print(f"Wrote wide_even/wide_odd for {groups} group(s), {QUERIES_TXT.name} and {GOLDEN_TXT.name}")
+
+
+if __name__ == "__main__":
+    main()
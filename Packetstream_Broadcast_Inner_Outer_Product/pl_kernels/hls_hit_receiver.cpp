@@ -0,0 +1,92 @@
+/**********
+© Copyright 2020-2022 Xilinx, Inc.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**********/
+#include "hls_stream.h"
+#include "ap_int.h"
+#include "ap_axi_sdata.h"
+#include "packet_ids_c.h"
+#include "pl_config.h"
+
+static const int PACKET_NUM=PL_SHARDS;  //shards behind the pktmerge of Dataout0
+static const int MAX_HITS=PL_MAX_HITS;  //hit slots in the output buffer
+
+//packet id of each pktmerge input, i.e. of each shard; macro values are generated in packet_ids_c.h
+static const unsigned int packet_ids[PACKET_NUM]={Dataout0_0, Dataout0_1, Dataout0_2, Dataout0_3, Dataout0_4, Dataout0_5};
+
+unsigned int getPacketId(ap_uint<32> header){
+#pragma HLS inline
+	ap_uint<32> ID=0;
+	ID(4,0)=header(4,0);
+	return ID;
+}
+
+//shard whose packet id is ID, PACKET_NUM for an id no shard has
+unsigned int getShard(unsigned int ID){
+#pragma HLS inline
+	unsigned int shard=PACKET_NUM;
+	for(int i=0;i<PACKET_NUM;i++){
+		if(packet_ids[i]==ID) shard=i;
+	}
+	return shard;
+}
+
+void write_word(hls::stream<ap_axiu<32,0,0,0>> &out, ap_int<32> v, bool last){
+#pragma HLS inline
+	ap_axiu<32,0,0,0> tmp;
+	tmp.keep=-1;
+	tmp.data=v;
+	tmp.last=last;
+	out.write(tmp);
+}
+
+//Receives the variable-length hit packets of aie_core1_threshold (THRESHOLD_EMIT
+//in aie/graph.h): header, (score, id) pairs, then the hit count with TLAST.
+//Every hit is forwarded as soon as it arrives as a (score, shard, id) triple.
+//s2mm needs a fixed transfer size, so after total_num_packet packets the
+//unused slots up to MAX_HITS are padded with -1 and the total hit count
+//closes the buffer. Hits past MAX_HITS are counted but dropped; hits of a
+//packet with an unknown id are dropped without counting.
+void hls_hit_receiver(hls::stream<ap_axiu<32,0,0,0>> &in, hls::stream<ap_axiu<32,0,0,0>> &out,
+		const unsigned int total_num_packet){
+	unsigned int hits=0;
+
+	for(unsigned int iter=0;iter<total_num_packet;iter++){
+		ap_axiu<32,0,0,0> tmp=in.read();//first word is packet header
+		unsigned int shard=getShard(getPacketId(tmp.data));
+		bool last=false;
+		while(!last){
+#pragma HLS PIPELINE II=2
+			tmp=in.read();
+			last=tmp.last;
+			if(!last){
+				ap_int<32> score=tmp.data;
+				tmp=in.read();
+				if(shard<PACKET_NUM){
+					if(hits<MAX_HITS){
+						write_word(out,score,false);
+						write_word(out,shard,false);
+						write_word(out,tmp.data,false);
+					}
+					hits++;
+				}
+			}
+		}
+	}
+
+	for(unsigned int h=hits;h<MAX_HITS;h++){
+#pragma HLS PIPELINE II=3
+		write_word(out,-1,false);
+		write_word(out,-1,false);
+		write_word(out,-1,false);
+	}
+	write_word(out,hits,true);
+}
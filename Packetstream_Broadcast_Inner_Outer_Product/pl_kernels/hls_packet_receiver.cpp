@@ -14,11 +14,14 @@ limitations under the License.
 #include "ap_int.h"
 #include "ap_axi_sdata.h"
 #include "packet_ids_c.h"
+#include "pl_config.h"
 
-static const int PACKET_NUM=4;
-static const int PACKET_LEN=8;
+static const int PACKET_NUM=PL_SHARDS;  //shards behind the pktmerge of Dataout0
+static const int PACKET_LEN=F_Cb; //column maxima per result packet, then TRACE_WORDS stamps
+static const int TRACE_SLOTS=64; //result packets whose stamps are kept (sw/stage_trace.h)
 
-static const unsigned int packet_ids[PACKET_NUM]={Dataout0_0, Dataout0_1, Dataout0_2, Dataout0_3};
+//packet id of each pktmerge input, i.e. of each shard; macro values are generated in packet_ids_c.h
+static const unsigned int packet_ids[PACKET_NUM]={Dataout0_0, Dataout0_1, Dataout0_2, Dataout0_3, Dataout0_4, Dataout0_5};
 
 unsigned int getPacketId(ap_uint<32> header){
 #pragma HLS inline
@@ -27,20 +30,80 @@ unsigned int getPacketId(ap_uint<32> header){
 	return ID;
 }
 
-void hls_packet_receiver(hls::stream<ap_axiu<32,0,0,0>> &in, hls::stream<ap_axiu<32,0,0,0>> &out0,hls::stream<ap_axiu<32,0,0,0>> &out1,hls::stream<ap_axiu<32,0,0,0>> &out2,hls::stream<ap_axiu<32,0,0,0>> &out3,
+//shard whose packet id is ID, PACKET_NUM for an id no shard has
+unsigned int getShard(unsigned int ID){
+#pragma HLS inline
+	unsigned int shard=PACKET_NUM;
+	for(int i=0;i<PACKET_NUM;i++){
+		if(packet_ids[i]==ID) shard=i;
+	}
+	return shard;
+}
+
+//Receives the merged result packets of all shards and keeps, per query, the
+//best column maximum and the shard it came from. Packets with an unknown id
+//are drained but do not count. After total_num_packet
+//packets it writes PACKET_LEN (score, shard) pairs to out, followed by
+//TRACE_SLOTS (shard, entry, exit) cycle stamps of the first packets in
+//arrival order; unused slots have shard -1, all of them without STAGE_TRACE
+//(aie/system_settings.h), whose setting also fixes the packet length.
+void hls_packet_receiver(hls::stream<ap_axiu<32,0,0,0>> &in, hls::stream<ap_axiu<32,0,0,0>> &out,
 		const unsigned int total_num_packet){
+	ap_int<32> best[PACKET_LEN];
+	ap_uint<32> bestShard[PACKET_LEN];
+	for(int j=0;j<PACKET_LEN;j++){
+		best[j]=0x80000000; //INT32_MIN
+		bestShard[j]=-1;
+	}
+	ap_uint<32> trace[TRACE_SLOTS][3];
+	for(int t=0;t<TRACE_SLOTS;t++){
+		trace[t][0]=-1;
+		trace[t][1]=0;
+		trace[t][2]=0;
+	}
+
 	for(unsigned int iter=0;iter<total_num_packet;iter++){
 		ap_axiu<32,0,0,0> tmp=in.read();//first word is packet header
-		unsigned int ID=getPacketId(tmp.data);
-		unsigned int channel=packet_ids[ID];
+		unsigned int shard=getShard(getPacketId(tmp.data));
 		for(int j=0;j<PACKET_LEN;j++){
+#pragma HLS PIPELINE II=1
 			tmp=in.read();
-			switch(channel){
-			case 0:out0.write(tmp);break;
-			case 1:out1.write(tmp);break;
-			case 2:out2.write(tmp);break;
-			case 3:out3.write(tmp);break;
+			ap_int<32> v=tmp.data;
+			if(shard<PACKET_NUM && v>best[j]){
+				best[j]=v;
+				bestShard[j]=shard;
 			}
 		}
+#ifdef STAGE_TRACE
+		ap_uint<32> stamp[TRACE_WORDS];
+		for(int w=0;w<TRACE_WORDS;w++){
+			tmp=in.read();
+			stamp[w]=tmp.data;
+		}
+		if(shard<PACKET_NUM && iter<TRACE_SLOTS){
+			trace[iter][0]=shard;
+			trace[iter][1]=stamp[0];
+			trace[iter][2]=stamp[1];
+		}
+#endif
+	}
+
+	for(int j=0;j<PACKET_LEN;j++){
+		ap_axiu<32,0,0,0> tmp;
+		tmp.keep=-1;
+		tmp.data=best[j];
+		tmp.last=0;
+		out.write(tmp);
+		tmp.data=bestShard[j];
+		out.write(tmp);
+	}
+	for(int t=0;t<TRACE_SLOTS;t++){
+		for(int w=0;w<3;w++){
+			ap_axiu<32,0,0,0> tmp;
+			tmp.keep=-1;
+			tmp.data=trace[t][w];
+			tmp.last=(t==TRACE_SLOTS-1 && w==2);
+			out.write(tmp);
+		}
 	}
 }
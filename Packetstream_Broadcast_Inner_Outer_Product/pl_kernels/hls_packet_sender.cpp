@@ -14,12 +14,13 @@ limitations under the License.
 #include "ap_int.h"
 #include "ap_axi_sdata.h"
 #include "packet_ids_c.h"
+#include "pl_config.h"
 
 static const unsigned int pktType=0;
-static const int PACKET_NUM=4; //How many kernels do packet switching
-static const int PACKET_LEN=8; //Length for a packet
+static const int PACKET_NUM=PL_SHARDS; //shards behind the pktsplit of Datain0, one mm2s each
+static const int PACKET_LEN=F_Ra*F_Ca; //corpus block per packet; the ATTRIBUTE_FILTER packets are F_Ra words longer and not sent from PL
 
-static const unsigned int packet_ids[PACKET_NUM]={Datain0_0, Datain0_1, Datain0_2, Datain0_3}; //macro values are generated in packet_ids_c.h
+static const unsigned int packet_ids[PACKET_NUM]={Datain0_0, Datain0_1, Datain0_2, Datain0_3, Datain0_4, Datain0_5}; //macro values are generated in packet_ids_c.h
 
 ap_uint<32> generateHeader(unsigned int pktType, unsigned int ID){
 #pragma HLS inline
@@ -36,6 +37,7 @@ ap_uint<32> generateHeader(unsigned int pktType, unsigned int ID){
 }
 
 void hls_packet_sender(hls::stream<ap_axiu<32,0,0,0>> &s0,hls::stream<ap_axiu<32,0,0,0>> &s1,hls::stream<ap_axiu<32,0,0,0>> &s2,hls::stream<ap_axiu<32,0,0,0>> &s3,
+		hls::stream<ap_axiu<32,0,0,0>> &s4,hls::stream<ap_axiu<32,0,0,0>> &s5,
 		hls::stream<ap_axiu<32,0,0,0>> &out, const unsigned int num){
 	for(unsigned int iter=0;iter<num;iter++){
 		for(int i=0;i<PACKET_NUM;i++){//Iterate on PL kernels that do packet switching
@@ -52,6 +54,8 @@ void hls_packet_sender(hls::stream<ap_axiu<32,0,0,0>> &s0,hls::stream<ap_axiu<32
 				case 1:tmp=s1.read();break;
 				case 2:tmp=s2.read();break;
 				case 3:tmp=s3.read();break;
+				case 4:tmp=s4.read();break;
+				case 5:tmp=s5.read();break;
 				}
 				if(j==PACKET_LEN-1){
 					tmp.last=1; //last word in a packet has TLAST=1
@@ -1,6 +1,12 @@
-#define StreamIn0_0 0
-#define StreamIn0_1 1
-#define StreamIn0_2 2
-#define StreamOut0_0_0 0
-#define StreamOut0_1_0 0
-#define StreamOut0_2_0 0
+#define Datain0_0 0
+#define Datain0_1 1
+#define Datain0_2 2
+#define Datain0_3 3
+#define Datain0_4 4
+#define Datain0_5 5
+#define Dataout0_0 0
+#define Dataout0_1 1
+#define Dataout0_2 2
+#define Dataout0_3 3
+#define Dataout0_4 4
+#define Dataout0_5 5
@@ -0,0 +1,37 @@
+/**********
+© Copyright 2020-2022 Xilinx, Inc.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**********/
+#ifndef __PL_CONFIG_H__
+#define __PL_CONFIG_H__
+
+#include "../aie/placement.h"
+#include "../aie/system_settings.h"
+
+//Shards the PL path serves, shared by the PL kernels and sw/host.cpp; must
+//match N in aie/graph.h (the host checks)
+#define PL_SHARDS 6
+
+//Graph iterations of one host run: corpus packets per shard, and result
+//packets per shard behind the pktmerge
+#define PL_BLOCKS 2
+
+//Hit slots of hls_hit_receiver's output buffer (THRESHOLD_EMIT): every
+//query of every result packet of the run above min_score
+#define PL_MAX_HITS (PL_SHARDS * PL_BLOCKS * F_Cb)
+
+//The PL path is one pktsplit/pktmerge group: hls_packet_sender feeds Datain0
+//and the receivers drain Dataout0, with the Datain0_<k>/Dataout0_<k> ids of
+//packet_ids_c.h. More than PKTSPLIT_MAX shards need a sender and receiver
+//per group and the ids of the other groups.
+static_assert(ShardPlacement::groups(PL_SHARDS)==1, "the PL path wires pktsplit group 0 only");
+
+#endif
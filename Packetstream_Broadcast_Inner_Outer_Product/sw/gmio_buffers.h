@@ -0,0 +1,84 @@
+/**********
+© Copyright 2020-2022 Xilinx, Inc.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**********/
+#ifndef __GMIO_BUFFERS_H__
+#define __GMIO_BUFFERS_H__
+
+#include <string>
+#include <thread>
+#include <vector>
+#include "experimental/xrt_aie.h"
+#include "experimental/xrt_bo.h"
+
+// DDR buffers behind the GMIO ports of gmioGraph. One buffer object per
+// port, mapped into the host; start() launches every transfer on its own
+// thread because xrtAIESyncBO blocks until the tile DMA is done, and the
+// corpus, query and result transfers of a run must be in flight together.
+class GmioBufferManager {
+public:
+	explicit GmioBufferManager(xrtDeviceHandle dhdl) : dhdl_(dhdl) {}
+
+	~GmioBufferManager() {
+		for (Port& p : ports_) xrtBOFree(p.bo);
+	}
+
+	// Allocates bytes of DDR for the named port and returns the host mapping.
+	// Register every port before the first start().
+	void* add_input(const std::string& name, size_t bytes) {
+		return add(name, bytes, XCL_BO_SYNC_BO_GMIO_TO_AIE);
+	}
+	void* add_output(const std::string& name, size_t bytes) {
+		return add(name, bytes, XCL_BO_SYNC_BO_AIE_TO_GMIO);
+	}
+
+	// Moves every buffer: inputs DDR -> AIE, outputs AIE -> DDR
+	void start() {
+		for (Port& p : ports_) {
+			Port* port = &p;
+			threads_.emplace_back([this, port] {
+				port->ret = xrtAIESyncBO(dhdl_, port->bo, port->name.c_str(), port->dir, port->bytes, 0);
+			});
+		}
+	}
+
+	// Blocks until all transfers are done; 0 on success
+	int wait() {
+		for (std::thread& t : threads_) t.join();
+		threads_.clear();
+		int ret = 0;
+		for (const Port& p : ports_) {
+			if (p.ret && !ret) ret = p.ret;
+		}
+		return ret;
+	}
+
+private:
+	struct Port {
+		std::string name;
+		xrtBufferHandle bo;
+		size_t bytes;
+		xclBOSyncDirection dir;
+		int ret;
+	};
+
+	void* add(const std::string& name, size_t bytes, xclBOSyncDirection dir) {
+		Port p = {name, xrtBOAlloc(dhdl_, bytes, 0, /*BANK=*/0), bytes, dir, 0};
+		ports_.push_back(p);
+		return xrtBOMap(p.bo);
+	}
+
+	xrtDeviceHandle dhdl_;
+	std::vector<Port> ports_;
+	std::vector<std::thread> threads_;
+};
+
+#endif
@@ -0,0 +1,46 @@
+/**********
+© Copyright 2020-2022 Xilinx, Inc.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**********/
+#ifndef __HIT_DECODER_H__
+#define __HIT_DECODER_H__
+
+#include <vector>
+#include "../pl_kernels/pl_config.h"
+
+// Output buffer of hls_hit_receiver (THRESHOLD_EMIT): HIT_SLOTS (score,
+// shard, id) triples, unused ones -1, followed by the total hit count. The
+// id is query << 16 | row as written by aie_core1_threshold.
+static const int HIT_SLOTS = PL_MAX_HITS;
+static const int HIT_BUFFER_WORDS = 3 * HIT_SLOTS + 1;
+
+struct Hit {
+	int score;
+	int shard;
+	int query;
+	int row;
+};
+
+// Decodes buf into hits and returns the hit count reported by the receiver;
+// a count above HIT_SLOTS means the tail was dropped and min_score should be
+// raised
+static inline int decode_hits(const int* buf, std::vector<Hit>& hits) {
+	const int count = buf[3 * HIT_SLOTS];
+	const int stored = count < HIT_SLOTS ? count : HIT_SLOTS;
+	hits.clear();
+	for (int h = 0; h < stored; h++) {
+		const int* t = buf + 3 * h;
+		hits.push_back(Hit{t[0], t[1], t[2] >> 16, t[2] & 0xffff});
+	}
+	return count;
+}
+
+#endif
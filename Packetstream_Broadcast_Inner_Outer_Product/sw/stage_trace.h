@@ -0,0 +1,180 @@
+/**********
+© Copyright 2020-2022 Xilinx, Inc.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+**********/
+#ifndef __STAGE_TRACE_H__
+#define __STAGE_TRACE_H__
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Trace words behind the (score, shard) pairs in the hls_packet_receiver
+// output: TRACE_SLOTS (shard, entry, exit) triples, one per result packet
+// in arrival order, unused ones with shard -1. Entry and exit are the low
+// 32 bits of the tile cycle counter as the kernels write them with
+// STAGE_TRACE (aie/system_settings.h).
+static const int TRACE_SLOTS = 64;	// TRACE_SLOTS in pl_kernels/hls_packet_receiver.cpp
+static const int TRACE_BUFFER_WORDS = 3 * TRACE_SLOTS;
+
+// Per-stage timeline of a run: spans on the host, the PL kernels and the
+// AIE tiles, each tagged with the query batch (graph iteration) it belongs
+// to, or -1 when the whole run passes through it. Written as Chrome trace
+// JSON (chrome://tracing, Perfetto): one process per domain, one thread per
+// stage, and the spans of every query chained by flow arrows. Times are
+// microseconds of the host steady clock; the software twin records its
+// stages on the same clock, so its wall time lines up with the host's.
+class StageTrace {
+public:
+	enum Domain { HOST = 1, PL = 2, AIE = 3 };
+
+	static StageTrace& get() {
+		static StageTrace trace;
+		return trace;
+	}
+
+	double now_us() const {
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch_).count();
+	}
+
+	void span(Domain domain, const std::string& track, const std::string& name, int query,
+			double begin_us, double end_us) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		events_.push_back(Event{domain, track, name, query, begin_us, end_us - begin_us});
+	}
+
+	size_t size() const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return events_.size();
+	}
+
+	// Adds the aie_core1 spans of a receiver trace buffer, the k-th packet
+	// of a shard being query k. Tile counters are not synchronized with the
+	// host clock, so the earliest entry is placed at run_us, the host time
+	// the graph was started. Returns the packets decoded per shard.
+	std::vector<int> add_aie_trace(const int* buf, int shards, double clock_mhz, double run_us) {
+		std::vector<int> packets(shards, 0);
+		int first = -1;
+		int64_t earliest = 0;
+		for (int t = 0; t < TRACE_SLOTS; t++) {
+			if (buf[3 * t] < 0 || buf[3 * t] >= shards) continue;
+			if (first < 0) first = t;
+			earliest = std::min(earliest, rel_cycles(buf, first, t));
+		}
+		for (int t = first < 0 ? TRACE_SLOTS : first; t < TRACE_SLOTS; t++) {
+			const int shard = buf[3 * t];
+			if (shard < 0 || shard >= shards) continue;
+			const uint32_t busy = (uint32_t)buf[3 * t + 2] - (uint32_t)buf[3 * t + 1];
+			const double begin = run_us + (rel_cycles(buf, first, t) - earliest) / clock_mhz;
+			const int query = packets[shard]++;
+			span(AIE, "aie_core1[" + std::to_string(shard) + "]", "aie_core1 q" + std::to_string(query), query,
+					begin, begin + busy / clock_mhz);
+		}
+		return packets;
+	}
+
+	bool write_chrome_json(const std::string& path) const {
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::ofstream f(path);
+		if (!f) return false;
+		f.precision(3);
+		f << std::fixed << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+		static const char* domains[] = {"", "host", "PL", "AIE"};
+		for (int d = HOST; d <= AIE; d++)
+			f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << d << ",\"args\":{\"name\":\"" << domains[d]
+			  << "\"}},\n";
+		std::map<std::pair<int, std::string>, int> tids;
+		for (const Event& e : events_) {
+			auto key = std::make_pair((int)e.domain, e.track);
+			if (tids.count(key)) continue;
+			const int tid = (int)tids.size() + 1;
+			tids[key] = tid;
+			f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << e.domain << ",\"tid\":" << tid
+			  << ",\"args\":{\"name\":\"" << escape(e.track) << "\"}},\n";
+		}
+
+		std::map<int, std::vector<const Event*>> by_query;
+		for (const Event& e : events_) {
+			f << "{\"name\":\"" << escape(e.name) << "\",\"cat\":\"" << domains[e.domain]
+			  << "\",\"ph\":\"X\",\"pid\":" << e.domain << ",\"tid\":" << tids[std::make_pair((int)e.domain, e.track)]
+			  << ",\"ts\":" << e.ts << ",\"dur\":" << e.dur << ",\"args\":{\"query\":" << e.query << "}},\n";
+			if (e.query >= 0) by_query[e.query];
+		}
+		// every query's chain: its own spans plus the run-wide ones, in start order
+		for (auto& q : by_query) {
+			for (const Event& e : events_)
+				if (e.query < 0 || e.query == q.first) q.second.push_back(&e);
+			std::stable_sort(q.second.begin(), q.second.end(),
+					[](const Event* a, const Event* b) { return a->ts < b->ts; });
+			for (size_t i = 0; i < q.second.size(); i++) {
+				const Event& e = *q.second[i];
+				const char* ph = i == 0 ? "s" : i + 1 == q.second.size() ? "f" : "t";
+				f << "{\"name\":\"query " << q.first << "\",\"cat\":\"query\",\"ph\":\"" << ph << "\",\"bp\":\"e\",\"id\":"
+				  << q.first << ",\"pid\":" << e.domain << ",\"tid\":" << tids[std::make_pair((int)e.domain, e.track)]
+				  << ",\"ts\":" << e.ts + e.dur / 2 << "},\n";
+			}
+		}
+		// closing metadata event, so every event above can end with a comma
+		f << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << HOST << ",\"args\":{\"sort_index\":0}}\n]}\n";
+		return (bool)f;
+	}
+
+private:
+	struct Event {
+		Domain domain;
+		std::string track, name;
+		int query;
+		double ts, dur;
+	};
+
+	StageTrace() : epoch_(std::chrono::steady_clock::now()) {}
+
+	// Entry cycle of slot t relative to slot ref; runs are far shorter than
+	// the 2^31 cycles a signed 32-bit difference covers
+	static int64_t rel_cycles(const int* buf, int ref, int t) {
+		return (int32_t)((uint32_t)buf[3 * t + 1] - (uint32_t)buf[3 * ref + 1]);
+	}
+
+	static std::string escape(const std::string& s) {
+		std::string out;
+		for (char c : s) {
+			if (c == '"' || c == '\\') out += '\\';
+			out += c;
+		}
+		return out;
+	}
+
+	std::chrono::steady_clock::time_point epoch_;
+	mutable std::mutex mutex_;
+	std::vector<Event> events_;
+};
+
+// Records the enclosing scope as a span
+class StageSpan {
+public:
+	StageSpan(StageTrace::Domain domain, const std::string& track, const std::string& name, int query = -1)
+		: domain_(domain), track_(track), name_(name), query_(query), begin_(StageTrace::get().now_us()) {}
+	~StageSpan() { StageTrace::get().span(domain_, track_, name_, query_, begin_, StageTrace::get().now_us()); }
+
+private:
+	StageTrace::Domain domain_;
+	std::string track_, name_;
+	int query_;
+	double begin_;
+};
+
+#endif
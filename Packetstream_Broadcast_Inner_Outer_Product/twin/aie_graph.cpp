@@ -0,0 +1,167 @@
+#include "aie_graph.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "placement.h"
+#include "stage_trace.h"
+#include "system_settings.h"
+
+namespace twin {
+
+static const unsigned pktType = 0;
+
+// Packet header as writeHeader() builds it on a tile: packet id, packet
+// type, source row and column, odd parity in bit 31
+static uint32_t packet_header(unsigned type, unsigned id, int row, int col) {
+	uint32_t h = (id & 0x1f) | (type & 0x7) << 12 | (uint32_t)(row & 0x1f) << 16 | (uint32_t)(col & 0x7f) << 21;
+	if (!__builtin_parity(h)) h |= 1u << 31;
+	return h;
+}
+
+#ifdef STAGE_TRACE
+// Tile cycle counter of the twin: host steady clock at AIE_CLOCK_MHZ, so the
+// stamps the host decodes are wall time
+static uint32_t tile_cycles() {
+	return (uint32_t)(uint64_t)(StageTrace::get().now_us() * AIE_CLOCK_MHZ);
+}
+#endif
+
+static Beat beat(uint32_t data, bool last) {
+	Beat b;
+	b.data = data;
+	b.keep = -1;
+	b.last = last;
+	return b;
+}
+
+PacketGraph::PacketGraph(int nshards)
+	: nshards_(nshards), groups_(ShardPlacement::groups(nshards)), group_(ShardPlacement::group_size(nshards)) {
+	for (int i = 0; i < nshards_; ++i) {
+		const std::string core = "aie_core1[" + std::to_string(i) + "]";
+		split_out_.emplace_back(new AxisStream("pktsplit->" + core + ".in[0]", STREAM_DEPTH));
+		query_in_.emplace_back(new AxisStream("StreamIn1_broadcast->" + core + ".in[1]", STREAM_DEPTH));
+		core_out_.emplace_back(new AxisStream(core + ".out[0]->pktmerge", STREAM_DEPTH));
+	}
+}
+
+PacketGraph::~PacketGraph() { wait(); }
+
+void PacketGraph::run(int iterations) {
+	if (!attached_device()) {
+		std::cout << "twin: graph run before adf::registerXRT" << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+	for (int g = 0; g < groups_; ++g) {
+		threads_.emplace_back(&PacketGraph::pktsplit, this, g, iterations);
+		threads_.emplace_back(&PacketGraph::pktmerge, this, g, iterations);
+	}
+	for (int i = 0; i < nshards_; ++i) threads_.emplace_back(&PacketGraph::core, this, i, iterations);
+	threads_.emplace_back(&PacketGraph::broadcast, this, iterations);
+}
+
+void PacketGraph::wait() {
+	for (std::thread& t : threads_) t.join();
+	threads_.clear();
+}
+
+// Routes every packet of Datain<g> by the packet id in its header to the
+// core of that index in the group; the header goes along
+void PacketGraph::pktsplit(int g, int iterations) {
+	StageScope stage("pktsplit[" + std::to_string(g) + "]");
+	StageSpan span(StageTrace::AIE, "pktsplit[" + std::to_string(g) + "]", "pktsplit");
+	AxisStream& in = attached_device()->stream("ai_engine_0.Datain" + std::to_string(g));
+	const int width = ShardPlacement::group_size(nshards_, g);
+	for (int p = 0; p < iterations * width; ++p) {
+		Beat b = in.pop();
+		const unsigned id = (unsigned)(b.data & 0x1f);
+		if ((int)id >= width) {
+			std::cout << "twin: pktsplit[" << g << "] got packet id " << id << ", only " << width
+			          << " outputs" << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		AxisStream& out = *split_out_[g * group_ + id];
+		out.push(b);
+		do {
+			b = in.pop();
+			out.push(b);
+		} while (!b.last);
+	}
+}
+
+// aie_core1: header, the F_Ra x F_Ca corpus block on in[0] and the query
+// batch on in[1], both int32 in MMUL tile order; one result packet of F_Cb
+// column maxima and, with STAGE_TRACE, the entry and exit stamps. Word
+// counts are fixed as in the kernel, TLAST is not looked at on the way in.
+void PacketGraph::core(int i, int iterations) {
+	StageScope stage("aie_core1[" + std::to_string(i) + "]");
+	AxisStream& in0 = *split_out_[i];
+	AxisStream& in1 = *query_in_[i];
+	AxisStream& out = *core_out_[i];
+	std::vector<float> A(F_Ra * F_Ca), B(F_Rb * F_Cb);
+	const unsigned id = i % group_;   // Dataout<g>_<id> in packet_ids_c.h
+
+	for (int it = 0; it < iterations; ++it) {
+#ifdef STAGE_TRACE
+		const uint32_t entry = tile_cycles();
+#endif
+		in0.pop();
+		for (float& a : A) a = (float)(int32_t)(uint32_t)in0.pop().data;
+		for (float& b : B) b = (float)(int32_t)(uint32_t)in1.pop().data;
+
+		out.push(beat(packet_header(pktType, id, ShardPlacement::row(i), ShardPlacement::col(nshards_, i)), false));
+		for (int j = 0; j < F_Cb; ++j) {
+			float best = -1e30f;
+			for (int r = 0; r < F_Ra; ++r) {
+				float v = 0.0f;
+				for (int k = 0; k < F_Ca; ++k)
+					v += A[((r / 4) * (F_Ca / 2) + k / 2) * 8 + (r % 4) * 2 + k % 2] *
+					     B[((k / 2) * (F_Cb / 4) + j / 4) * 8 + (k % 2) * 4 + j % 4];
+				if (v > best) best = v;
+			}
+			out.push(beat((uint32_t)(int32_t)best, TRACE_WORDS == 0 && j == F_Cb - 1));
+		}
+#ifdef STAGE_TRACE
+		out.push(beat(entry, false));
+		out.push(beat(tile_cycles(), true));
+#endif
+	}
+}
+
+// Forwards whole packets from the group's cores in arrival order
+void PacketGraph::pktmerge(int g, int iterations) {
+	StageScope stage("pktmerge[" + std::to_string(g) + "]");
+	StageSpan span(StageTrace::AIE, "pktmerge[" + std::to_string(g) + "]", "pktmerge");
+	AxisStream& out = attached_device()->stream("ai_engine_0.Dataout" + std::to_string(g));
+	const std::string what = "empty pktmerge[" + std::to_string(g) + "] inputs";
+	int next = 0;
+	const int width = ShardPlacement::group_size(nshards_, g);
+	for (int p = 0; p < iterations * width; ++p) {
+		Wait w(what.c_str());
+		while (core_out_[g * group_ + next]->empty()) {
+			next = (next + 1) % width;
+			w.again();
+		}
+		w.done();
+		AxisStream& in = *core_out_[g * group_ + next];
+		Beat b;
+		do {
+			b = in.pop();
+			out.push(b);
+		} while (!b.last);
+		next = (next + 1) % width;
+	}
+}
+
+void PacketGraph::broadcast(int iterations) {
+	StageScope stage("StreamIn1_broadcast");
+	StageSpan span(StageTrace::AIE, "StreamIn1_broadcast", "broadcast");
+	AxisStream& in = attached_device()->stream("ai_engine_0.StreamIn1_broadcast");
+	for (int w = 0; w < iterations * F_Rb * F_Cb; ++w) {
+		const Beat b = in.pop();
+		for (auto& q : query_in_) q->push(b);
+	}
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef __TWIN_AIE_GRAPH_H__
+#define __TWIN_AIE_GRAPH_H__
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "device.h"
+
+namespace twin {
+
+// Thread model of shardedGraph (aie/graph.h) in its default mode: per
+// pktsplit group the Datain<g> PLIO feeds a pktsplit, GROUP aie_core1
+// kernels and a pktmerge onto Dataout<g>; StreamIn1_broadcast is copied to
+// every core. Each block is a stage thread and every connection a bounded
+// lock-free queue carrying the same words, packet headers and TLAST as on
+// the array. The PLIOs are the device streams system.cfg connects them to.
+class PacketGraph {
+public:
+	explicit PacketGraph(int nshards);
+	~PacketGraph();
+
+	void init() {}
+	// Starts iterations graph iterations, as graph::run; needs registerXRT
+	void run(int iterations);
+	void wait();
+	void end() { wait(); }
+
+private:
+	void pktsplit(int g, int iterations);
+	void core(int i, int iterations);
+	void pktmerge(int g, int iterations);
+	void broadcast(int iterations);
+
+	int nshards_, groups_, group_;
+	std::vector<std::unique_ptr<AxisStream>> split_out_, query_in_, core_out_;
+	std::vector<std::thread> threads_;
+};
+
+}
+
+#endif
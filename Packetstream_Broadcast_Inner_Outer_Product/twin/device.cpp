@@ -0,0 +1,104 @@
+#include "device.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace twin {
+
+static Device* attached = nullptr;
+
+Device* attached_device() { return attached; }
+void attach_device(Device* dev) { attached = dev; }
+
+static std::string trim(const std::string& s) {
+	const size_t b = s.find_first_not_of(" \t\r");
+	const size_t e = s.find_last_not_of(" \t\r");
+	return b == std::string::npos ? "" : s.substr(b, e - b + 1);
+}
+
+int Device::load_config(const std::string& path) {
+	std::ifstream f(path);
+	if (!f) {
+		std::cout << "twin: cannot open " << path << std::endl;
+		return 1;
+	}
+	std::string line, section;
+	int lineno = 0;
+	while (std::getline(f, line)) {
+		++lineno;
+		line = trim(line.substr(0, line.find('#')));
+		if (line.empty()) continue;
+		if (line[0] == '[') {
+			section = line;
+			continue;
+		}
+		if (section != "[connectivity]") continue;
+
+		const size_t eq = line.find('=');
+		const std::string key = trim(line.substr(0, eq));
+		const std::string val = eq == std::string::npos ? "" : trim(line.substr(eq + 1));
+		if (key == "nk") {
+			// nk=<kernel>:<count>[:<inst>.<inst>...]
+			std::stringstream ss(val);
+			std::string kernel, count, names;
+			std::getline(ss, kernel, ':');
+			std::getline(ss, count, ':');
+			std::getline(ss, names);
+			const int n = std::atoi(count.c_str());
+			std::stringstream ns(names);
+			for (int i = 0; i < n; ++i) {
+				std::string inst;
+				if (!std::getline(ns, inst, '.') || inst.empty()) inst = kernel + "_" + std::to_string(i + 1);
+				instances_[inst] = kernel;
+				order_.push_back(inst);
+			}
+		} else if (key == "stream_connect") {
+			// stream_connect=<src>.<port>:<dst>.<port>[:<depth>]
+			std::stringstream ss(val);
+			std::string src, dst;
+			std::getline(ss, src, ':');
+			std::getline(ss, dst, ':');
+			if (src.empty() || dst.empty() || endpoints_.count(src) || endpoints_.count(dst)) {
+				std::cout << "twin: " << path << ":" << lineno << ": bad or repeated stream_connect " << val << std::endl;
+				return 1;
+			}
+			streams_.emplace_back(new AxisStream(src + "->" + dst, STREAM_DEPTH));
+			endpoints_[src] = endpoints_[dst] = streams_.back().get();
+		}
+	}
+	return 0;
+}
+
+std::string Device::kernel_of(const std::string& inst) const {
+	auto it = instances_.find(inst);
+	return it == instances_.end() ? "" : it->second;
+}
+
+std::string Device::instance_of(const std::string& kernel) const {
+	for (const std::string& inst : order_)
+		if (instances_.at(inst) == kernel) return inst;
+	return "";
+}
+
+AxisStream& Device::stream(const std::string& endpoint) {
+	std::lock_guard<std::mutex> lock(mu_);
+	auto it = endpoints_.find(endpoint);
+	if (it != endpoints_.end()) return *it->second;
+	streams_.emplace_back(new AxisStream(endpoint + " (unconnected)", STREAM_DEPTH));
+	endpoints_[endpoint] = streams_.back().get();
+	return *streams_.back();
+}
+
+int Device::report_leftovers() const {
+	std::lock_guard<std::mutex> lock(mu_);
+	int n = 0;
+	for (const auto& s : streams_) {
+		if (s->empty()) continue;
+		std::cout << "twin: " << s->size() << " beats left in " << s->name() << std::endl;
+		++n;
+	}
+	return n;
+}
+
+}
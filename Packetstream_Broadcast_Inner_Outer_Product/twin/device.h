@@ -0,0 +1,57 @@
+#ifndef __TWIN_DEVICE_H__
+#define __TWIN_DEVICE_H__
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ap_axi_sdata.h"
+#include "hls_stream.h"
+
+namespace twin {
+
+// One 32-bit stream beat, as on every PLIO and PL stream of the design
+typedef ap_axiu<32, 0, 0, 0> Beat;
+typedef hls::stream<Beat> AxisStream;
+
+// Stream depth of every connection, in beats
+static const size_t STREAM_DEPTH = 512;
+
+// The card: PL kernel instances and the stream fabric between them and the
+// AIE graph, both read from the v++ link config
+class Device {
+public:
+	// Parses nk= and stream_connect= of a v++ config; 0 on success
+	int load_config(const std::string& path);
+
+	bool has_instance(const std::string& inst) const { return instances_.count(inst) != 0; }
+	// Kernel type of an instance, "" if unknown
+	std::string kernel_of(const std::string& inst) const;
+	// First instance of a kernel type, "" if none
+	std::string instance_of(const std::string& kernel) const;
+
+	// Stream at an "instance.port" endpoint (ai_engine_0.<PLIO> for the
+	// graph). An endpoint no stream_connect names gets a dangling stream,
+	// so its user stalls like on hardware and the monitor reports it.
+	AxisStream& stream(const std::string& endpoint);
+
+	// Prints the streams still holding beats; returns how many there are
+	int report_leftovers() const;
+
+private:
+	std::map<std::string, std::string> instances_;     // instance -> kernel
+	std::vector<std::string> order_;                   // instances in nk order
+	std::vector<std::unique_ptr<AxisStream>> streams_;
+	std::map<std::string, AxisStream*> endpoints_;
+	mutable std::mutex mu_;
+};
+
+// Device handed to adf::registerXRT, nullptr before
+Device* attached_device();
+void attach_device(Device* dev);
+
+}
+
+#endif
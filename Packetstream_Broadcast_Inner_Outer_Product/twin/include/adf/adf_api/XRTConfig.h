@@ -0,0 +1,14 @@
+#ifndef __TWIN_XRT_CONFIG_H__
+#define __TWIN_XRT_CONFIG_H__
+
+#include "experimental/xrt_kernel.h"
+
+namespace adf {
+
+// Attaches the graph model to the device, so its PLIOs find the streams
+// system.cfg connects them to
+void registerXRT(xrtDeviceHandle dhdl, const unsigned char* uuid);
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef __TWIN_AP_INT_H__
+#define __TWIN_AP_INT_H__
+
+// Native stand-in for the Vitis HLS arbitrary-precision integers, enough of
+// ap_uint/ap_int for the PL kernels: W-bit wrap-around values, bit and
+// range access and xor_reduce. Widths up to 64 bits; an ap_uint<32> is four
+// bytes, so a buffer object can be read through an ap_uint<32>*.
+
+#include <cstdint>
+#include <type_traits>
+
+template <int W, bool SIGNED>
+class ap_bits {
+	static_assert(W > 0 && W <= 64, "twin ap_int supports 1 to 64 bits");
+
+public:
+	typedef typename std::conditional<(W <= 32), uint32_t, uint64_t>::type word_t;
+
+	static constexpr uint64_t mask() { return W == 64 ? ~0ull : (1ull << W) - 1; }
+
+	class range_ref {
+	public:
+		range_ref(ap_bits* p, int hi, int lo) : p_(p), hi_(hi), lo_(lo) {}
+
+		range_ref& operator=(long long x) {
+			p_->v_ = (word_t)(((uint64_t)p_->v_ & ~bits()) | (((uint64_t)x << lo_) & bits()));
+			return *this;
+		}
+		range_ref& operator=(const range_ref& o) { return *this = (long long)o.get(); }
+
+		uint64_t get() const { return ((uint64_t)p_->v_ & bits()) >> lo_; }
+		operator unsigned long long() const { return get(); }
+		bool xor_reduce() const { return __builtin_parityll(get()); }
+
+	private:
+		uint64_t bits() const {
+			const int w = hi_ - lo_ + 1;
+			return (w >= 64 ? ~0ull : (1ull << w) - 1) << lo_;
+		}
+		ap_bits* p_;
+		int hi_, lo_;
+	};
+
+	class bit_ref {
+	public:
+		bit_ref(ap_bits* p, int i) : p_(p), i_(i) {}
+		bit_ref& operator=(long long x) {
+			p_->v_ = (word_t)(((uint64_t)p_->v_ & ~(1ull << i_)) | ((uint64_t)(x & 1) << i_));
+			return *this;
+		}
+		bit_ref& operator=(const bit_ref& o) { return *this = (long long)(bool)o; }
+		operator bool() const { return ((uint64_t)p_->v_ >> i_) & 1; }
+
+	private:
+		ap_bits* p_;
+		int i_;
+	};
+
+	ap_bits() : v_(0) {}
+	ap_bits(long long x) : v_((word_t)((uint64_t)x & mask())) {}
+	template <int W2, bool S2>
+	ap_bits(const ap_bits<W2, S2>& o) : v_((word_t)((uint64_t)o.to_int64() & mask())) {}
+
+	long long to_int64() const {
+		const uint64_t u = v_;
+		if (SIGNED && W < 64 && (u >> (W - 1)) & 1) return (long long)(u | ~mask());
+		return (long long)u;
+	}
+	operator long long() const { return to_int64(); }
+
+	range_ref operator()(int hi, int lo) { return range_ref(this, hi, lo); }
+	range_ref range(int hi, int lo) { return range_ref(this, hi, lo); }
+	bit_ref operator[](int i) { return bit_ref(this, i); }
+	bool operator[](int i) const { return ((uint64_t)v_ >> i) & 1; }
+	bool xor_reduce() const { return __builtin_parityll((uint64_t)v_); }
+
+private:
+	word_t v_;
+};
+
+template <int W> using ap_uint = ap_bits<W, false>;
+template <int W> using ap_int = ap_bits<W, true>;
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef __TWIN_XRT_BO_H__
+#define __TWIN_XRT_BO_H__
+
+// Buffer objects of the twin (twin/xrt_shim.cpp). They live in host memory
+// the PL kernels read and write directly, so syncing is a no-op.
+
+#include <cstddef>
+
+typedef void* xrtDeviceHandle;
+typedef void* xrtBufferHandle;
+
+enum xclBOSyncDirection {
+	XCL_BO_SYNC_BO_TO_DEVICE = 0,
+	XCL_BO_SYNC_BO_FROM_DEVICE,
+};
+
+xrtBufferHandle xrtBOAlloc(xrtDeviceHandle dhdl, size_t size, unsigned flags, unsigned bank);
+void* xrtBOMap(xrtBufferHandle bhdl);
+int xrtBOSync(xrtBufferHandle bhdl, xclBOSyncDirection dir, size_t size, size_t offset);
+int xrtBOFree(xrtBufferHandle bhdl);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef __TWIN_XRT_KERNEL_H__
+#define __TWIN_XRT_KERNEL_H__
+
+// The part of the XRT native C API sw/host.cpp uses, implemented by the
+// software twin (twin/xrt_shim.cpp). The "xclbin" is the v++ link config
+// (system.cfg): its nk= lines instantiate the PL kernels and its
+// stream_connect= lines wire them to each other and to the AIE graph.
+
+#include <cstddef>
+#include <cstdio>
+
+#include "experimental/xrt_bo.h"
+
+typedef void* xrtKernelHandle;
+typedef void* xrtRunHandle;
+typedef unsigned char xuid_t[16];
+
+enum ert_cmd_state {
+	ERT_CMD_STATE_NEW = 1,
+	ERT_CMD_STATE_QUEUED = 2,
+	ERT_CMD_STATE_RUNNING = 3,
+	ERT_CMD_STATE_COMPLETED = 4,
+	ERT_CMD_STATE_ERROR = 5,
+};
+
+xrtDeviceHandle xrtDeviceOpen(unsigned int index);
+int xrtDeviceClose(xrtDeviceHandle dhdl);
+int xrtDeviceLoadXclbinFile(xrtDeviceHandle dhdl, const char* xclbin);
+int xrtDeviceGetXclbinUUID(xrtDeviceHandle dhdl, xuid_t out);
+
+// name is "kernel" or "kernel:{instance}"
+xrtKernelHandle xrtPLKernelOpen(xrtDeviceHandle dhdl, const xuid_t uuid, const char* name);
+int xrtKernelClose(xrtKernelHandle khdl);
+
+xrtRunHandle xrtRunOpen(xrtKernelHandle khdl);
+// Buffer arguments take an xrtBufferHandle, scalars an int
+int xrtRunSetArg(xrtRunHandle rhdl, int index, ...);
+int xrtRunStart(xrtRunHandle rhdl);
+ert_cmd_state xrtRunWait(xrtRunHandle rhdl);
+int xrtRunClose(xrtRunHandle rhdl);
+
+#endif
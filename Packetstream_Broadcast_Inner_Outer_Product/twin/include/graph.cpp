@@ -0,0 +1,14 @@
+// Stand-in for aie/graph.cpp in the twin build: sw/host.cpp includes
+// "graph.cpp" for the graph object gr, which here is the thread model of
+// the packet-switched graph.
+#include "system_settings.h"
+#include "../aie_graph.h"
+
+#if defined(BINARY_PREFILTER) || defined(GMIO_INPUT) || defined(THRESHOLD_EMIT) || \
+    defined(ATTRIBUTE_FILTER) || defined(WIDE_INGEST) || defined(OUTER_PRODUCT)
+#error "the twin models the default aie_core1 graph only"
+#endif
+
+#define N 6         // must match N in aie/graph.h
+
+twin::PacketGraph gr(N);
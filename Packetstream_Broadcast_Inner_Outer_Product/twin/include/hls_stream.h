@@ -0,0 +1,28 @@
+#ifndef __TWIN_HLS_STREAM_H__
+#define __TWIN_HLS_STREAM_H__
+
+// hls::stream on top of the twin's lock-free queue. The stream fabric owns
+// one per stream_connect of the v++ config and hands it to both ends.
+
+#include <string>
+
+#include "../spsc_queue.h"
+
+namespace hls {
+
+template <typename T>
+class stream : public twin::SpscQueue<T> {
+public:
+	explicit stream(const std::string& name = "hls::stream", size_t depth = 512)
+		: twin::SpscQueue<T>(name, depth) {}
+
+	T read() { return this->pop(); }
+	void read(T& v) { v = this->pop(); }
+	void write(const T& v) { this->push(v); }
+	bool read_nb(T& v) { return this->try_pop(v); }
+	bool write_nb(const T& v) { return this->try_push(v); }
+};
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "monitor.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace twin {
+
+Monitor& Monitor::get() {
+	static Monitor m;
+	return m;
+}
+
+Stage*& Monitor::current() {
+	static thread_local Stage* s = nullptr;
+	return s;
+}
+
+Monitor::Monitor() {
+	const char* env = std::getenv("TWIN_DEADLOCK_MS");
+	timeout_ms_ = env ? (unsigned)std::strtoul(env, nullptr, 10) : 2000;
+	watcher_ = std::thread(&Monitor::watch, this);
+}
+
+Monitor::~Monitor() {
+	stop_ = true;
+	watcher_.join();
+}
+
+Stage* Monitor::enter(const std::string& name) {
+	std::lock_guard<std::mutex> lock(mu_);
+	stages_.emplace_back();
+	Stage* s = &stages_.back();
+	s->name = name;
+	current() = s;
+	return s;
+}
+
+void Monitor::leave(Stage* s) {
+	s->done = true;
+	current() = nullptr;
+}
+
+void Monitor::watch() {
+	const unsigned poll_ms = 50;
+	std::vector<uint64_t> last;
+	unsigned stalled_ms = 0;
+	while (!stop_) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+		std::lock_guard<std::mutex> lock(mu_);
+		// stalled: some stage alive, every live stage blocked, and none of
+		// them got through a queue operation since the last poll
+		bool live = false, stalled = true;
+		std::vector<uint64_t> seq;
+		for (const Stage& s : stages_) {
+			seq.push_back(s.wait_seq.load(std::memory_order_relaxed));
+			if (s.done) continue;
+			live = true;
+			if (!s.waiting.load(std::memory_order_acquire)) stalled = false;
+		}
+		if (!live || seq != last) stalled = false;
+		last.swap(seq);
+		stalled_ms = stalled ? stalled_ms + poll_ms : 0;
+		if (stalled_ms >= timeout_ms_) {
+			report();
+			std::_Exit(EXIT_FAILURE);
+		}
+	}
+}
+
+void Monitor::report() {
+	std::cout << "DEADLOCK: no stage has made progress for " << timeout_ms_ << " ms" << std::endl;
+	for (const Stage& s : stages_) {
+		if (s.done) continue;
+		std::cout << "  " << s.name << " waiting on " << s.waiting.load() << std::endl;
+	}
+	std::cout << "TEST FAILED" << std::endl;
+}
+
+}
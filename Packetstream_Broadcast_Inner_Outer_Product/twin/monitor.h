@@ -0,0 +1,91 @@
+#ifndef __TWIN_MONITOR_H__
+#define __TWIN_MONITOR_H__
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace twin {
+
+// One pipeline stage (PL kernel run, AIE kernel, pktsplit, ...) running on
+// its own thread. waiting names the queue the stage is blocked on, wait_seq
+// counts the waits so the monitor can tell a stall from a busy stage.
+struct Stage {
+	std::string name;
+	std::atomic<const char*> waiting{nullptr};
+	std::atomic<uint64_t> wait_seq{0};
+	std::atomic<bool> done{false};
+};
+
+// Deadlock watchdog. When every live stage has been blocked on the same
+// queue operation for TWIN_DEADLOCK_MS (default 2000) it prints what each
+// stage waits for and exits, which is how a hardware run would hang.
+class Monitor {
+public:
+	static Monitor& get();
+
+	Stage* enter(const std::string& name);
+	void leave(Stage* s);
+
+	// Current thread's stage, nullptr on the host thread
+	static Stage*& current();
+
+private:
+	Monitor();
+	~Monitor();
+	void watch();
+	void report();
+
+	std::mutex mu_;
+	std::list<Stage> stages_;
+	std::atomic<bool> stop_{false};
+	unsigned timeout_ms_;
+	std::thread watcher_;
+};
+
+// Registers the calling thread as a stage for its lifetime
+class StageScope {
+public:
+	explicit StageScope(const std::string& name) : s_(Monitor::get().enter(name)) {}
+	~StageScope() { Monitor::get().leave(s_); }
+	StageScope(const StageScope&) = delete;
+	StageScope& operator=(const StageScope&) = delete;
+
+private:
+	Stage* s_;
+};
+
+// Backoff of a blocked queue operation: spins, then yields, and marks the
+// stage as waiting on what. Call done() once the operation went through.
+class Wait {
+public:
+	explicit Wait(const char* what) : what_(what) {}
+	~Wait() { done(); }
+
+	void again() {
+		if (++spins_ < 64) return;
+		if (!marked_ && Monitor::current()) {
+			Monitor::current()->wait_seq.fetch_add(1, std::memory_order_relaxed);
+			Monitor::current()->waiting.store(what_, std::memory_order_release);
+			marked_ = true;
+		}
+		std::this_thread::yield();
+	}
+
+	void done() {
+		if (marked_) Monitor::current()->waiting.store(nullptr, std::memory_order_release);
+		marked_ = false;
+	}
+
+private:
+	const char* what_;
+	unsigned spins_ = 0;
+	bool marked_ = false;
+};
+
+}
+
+#endif
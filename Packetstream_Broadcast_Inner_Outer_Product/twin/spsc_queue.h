@@ -0,0 +1,89 @@
+#ifndef __TWIN_SPSC_QUEUE_H__
+#define __TWIN_SPSC_QUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "monitor.h"
+
+namespace twin {
+
+// Bounded lock-free single-producer/single-consumer ring, the model of one
+// AXI4-Stream or AIE stream connection. Every connection of the design has
+// exactly one writer and one reader, so no locks are needed. Blocking push
+// and pop back off through twin::Wait, which lets the monitor see stalls.
+template <typename T>
+class SpscQueue {
+public:
+	explicit SpscQueue(const std::string& name = "stream", size_t depth = 512)
+		: name_(name), full_("full " + name), empty_("empty " + name) {
+		size_t cap = 1;
+		while (cap < depth) cap <<= 1;
+		buf_.resize(cap);
+		mask_ = cap - 1;
+	}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	const std::string& name() const { return name_; }
+
+	bool try_push(const T& v) {
+		const size_t t = tail_.load(std::memory_order_relaxed);
+		if (t - head_cache_ > mask_) {
+			head_cache_ = head_.load(std::memory_order_acquire);
+			if (t - head_cache_ > mask_) return false;
+		}
+		buf_[t & mask_] = v;
+		tail_.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool try_pop(T& v) {
+		const size_t h = head_.load(std::memory_order_relaxed);
+		if (h == tail_cache_) {
+			tail_cache_ = tail_.load(std::memory_order_acquire);
+			if (h == tail_cache_) return false;
+		}
+		v = buf_[h & mask_];
+		head_.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	void push(const T& v) {
+		if (try_push(v)) return;
+		Wait w(full_.c_str());
+		while (!try_push(v)) w.again();
+	}
+
+	T pop() {
+		T v;
+		if (try_pop(v)) return v;
+		Wait w(empty_.c_str());
+		while (!try_pop(v)) w.again();
+		return v;
+	}
+
+	// Consumer side only
+	bool empty() const { return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire); }
+	size_t size() const { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+private:
+	std::string name_, full_, empty_;
+	std::vector<T> buf_;
+	size_t mask_;
+	// consumer and producer indices padded onto their own cache lines
+	char pad0_[64];
+	std::atomic<size_t> head_{0};
+	size_t tail_cache_ = 0;
+	char pad1_[64];
+	std::atomic<size_t> tail_{0};
+	size_t head_cache_ = 0;
+	char pad2_[64];
+};
+
+}
+
+#endif
@@ -0,0 +1,200 @@
+// XRT native API on top of the twin device. Every xrtRunStart runs the PL
+// kernel's own source (pl_kernels/*.cpp, compiled against the HLS shim) on
+// a thread of its own; xrtRunWait joins it.
+#include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "adf/adf_api/XRTConfig.h"
+#include "device.h"
+#include "monitor.h"
+#include "stage_trace.h"
+
+using twin::AxisStream;
+
+// PL kernels, pl_kernels/*.cpp
+extern "C" void mm2s(ap_uint<32>* mem, AxisStream& s, int size);
+extern "C" void s2mm(ap_uint<32>* mem, AxisStream& s, int size);
+void hls_packet_sender(AxisStream& s0, AxisStream& s1, AxisStream& s2, AxisStream& s3, AxisStream& s4,
+		AxisStream& s5, AxisStream& out, const unsigned int num);
+void hls_packet_receiver(AxisStream& in, AxisStream& out, const unsigned int total_num_packet);
+
+namespace {
+
+struct Buffer {
+	std::vector<uint32_t> words;
+};
+
+struct Run;
+
+// Argument list of a kernel, one entry per argument: "*name" a buffer
+// object, "&name" a stream port (wired by the config, never set by the
+// host), "=name" a scalar
+struct KernelDef {
+	std::vector<std::string> args;
+	std::function<void(Run&)> body;
+};
+
+struct Kernel {
+	twin::Device* dev;
+	std::string name, instance;
+	const KernelDef* def;
+};
+
+struct Run {
+	Kernel* kernel;
+	std::vector<uintptr_t> values;
+	std::vector<AxisStream*> streams;
+	std::thread thread;
+
+	ap_uint<32>* bo(int i) { return reinterpret_cast<ap_uint<32>*>(reinterpret_cast<Buffer*>(values[i])->words.data()); }
+	AxisStream& stream(int i) { return *streams[i]; }
+	unsigned scalar(int i) { return (unsigned)values[i]; }
+};
+
+const std::map<std::string, KernelDef>& kernel_defs() {
+	static const std::map<std::string, KernelDef> defs = {
+		{"mm2s", {{"*mem", "&s", "=size"},
+			[](Run& r) { mm2s(r.bo(0), r.stream(1), (int)r.scalar(2)); }}},
+		{"s2mm", {{"*mem", "&s", "=size"},
+			[](Run& r) { s2mm(r.bo(0), r.stream(1), (int)r.scalar(2)); }}},
+		{"hls_packet_sender", {{"&s0", "&s1", "&s2", "&s3", "&s4", "&s5", "&out", "=num"},
+			[](Run& r) {
+				hls_packet_sender(r.stream(0), r.stream(1), r.stream(2), r.stream(3), r.stream(4),
+						r.stream(5), r.stream(6), r.scalar(7));
+			}}},
+		{"hls_packet_receiver", {{"&in", "&out", "=total_num_packet"},
+			[](Run& r) { hls_packet_receiver(r.stream(0), r.stream(1), r.scalar(2)); }}},
+	};
+	return defs;
+}
+
+twin::Device* device(xrtDeviceHandle dhdl) { return static_cast<twin::Device*>(dhdl); }
+
+}
+
+xrtDeviceHandle xrtDeviceOpen(unsigned int index) {
+	return index == 0 ? new twin::Device : nullptr;
+}
+
+int xrtDeviceClose(xrtDeviceHandle dhdl) {
+	twin::Device* dev = device(dhdl);
+	dev->report_leftovers();
+	if (twin::attached_device() == dev) twin::attach_device(nullptr);
+	delete dev;
+	return 0;
+}
+
+int xrtDeviceLoadXclbinFile(xrtDeviceHandle dhdl, const char* xclbin) {
+	return device(dhdl)->load_config(xclbin);
+}
+
+int xrtDeviceGetXclbinUUID(xrtDeviceHandle, xuid_t out) {
+	std::memset(out, 0, sizeof(xuid_t));
+	return 0;
+}
+
+xrtBufferHandle xrtBOAlloc(xrtDeviceHandle, size_t size, unsigned, unsigned) {
+	Buffer* b = new Buffer;
+	b->words.resize((size + 3) / 4);
+	return b;
+}
+
+void* xrtBOMap(xrtBufferHandle bhdl) { return static_cast<Buffer*>(bhdl)->words.data(); }
+
+int xrtBOSync(xrtBufferHandle, xclBOSyncDirection, size_t, size_t) { return 0; }
+
+int xrtBOFree(xrtBufferHandle bhdl) {
+	delete static_cast<Buffer*>(bhdl);
+	return 0;
+}
+
+xrtKernelHandle xrtPLKernelOpen(xrtDeviceHandle dhdl, const xuid_t, const char* name) {
+	twin::Device* dev = device(dhdl);
+	std::string kernel = name, inst;
+	const size_t brace = kernel.find(":{");
+	if (brace != std::string::npos) {
+		inst = kernel.substr(brace + 2, kernel.find('}') - brace - 2);
+		kernel = kernel.substr(0, brace);
+	} else {
+		inst = dev->instance_of(kernel);
+	}
+	auto def = kernel_defs().find(kernel);
+	if (def == kernel_defs().end() || dev->kernel_of(inst) != kernel) {
+		std::cout << "twin: no kernel " << name << " in the loaded config" << std::endl;
+		return nullptr;
+	}
+	return new Kernel{dev, kernel, inst, &def->second};
+}
+
+int xrtKernelClose(xrtKernelHandle khdl) {
+	delete static_cast<Kernel*>(khdl);
+	return 0;
+}
+
+xrtRunHandle xrtRunOpen(xrtKernelHandle khdl) {
+	if (!khdl) return nullptr;
+	Kernel* k = static_cast<Kernel*>(khdl);
+	Run* r = new Run;
+	r->kernel = k;
+	r->values.resize(k->def->args.size());
+	r->streams.resize(k->def->args.size());
+	return r;
+}
+
+int xrtRunSetArg(xrtRunHandle rhdl, int index, ...) {
+	Run* r = static_cast<Run*>(rhdl);
+	const std::vector<std::string>& args = r->kernel->def->args;
+	if (index < 0 || index >= (int)args.size() || args[index][0] == '&') {
+		std::cout << "twin: " << r->kernel->instance << " has no settable argument " << index << std::endl;
+		return 1;
+	}
+	va_list ap;
+	va_start(ap, index);
+	if (args[index][0] == '*') r->values[index] = reinterpret_cast<uintptr_t>(va_arg(ap, xrtBufferHandle));
+	else r->values[index] = (unsigned)va_arg(ap, int);
+	va_end(ap);
+	return 0;
+}
+
+int xrtRunStart(xrtRunHandle rhdl) {
+	Run* r = static_cast<Run*>(rhdl);
+	Kernel* k = r->kernel;
+	const std::vector<std::string>& args = k->def->args;
+	for (size_t i = 0; i < args.size(); ++i) {
+		if (args[i][0] == '&') {
+			r->streams[i] = &k->dev->stream(k->instance + "." + args[i].substr(1));
+		} else if (args[i][0] == '*' && !r->values[i]) {
+			std::cout << "twin: " << k->instance << " started without buffer " << args[i].substr(1) << std::endl;
+			return 1;
+		}
+	}
+	// the kernel's wall time nests inside the run span the host records
+	r->thread = std::thread([r] {
+		twin::StageScope stage(r->kernel->instance);
+		StageSpan span(StageTrace::PL, r->kernel->instance, r->kernel->instance + " active");
+		r->kernel->def->body(*r);
+	});
+	return 0;
+}
+
+ert_cmd_state xrtRunWait(xrtRunHandle rhdl) {
+	Run* r = static_cast<Run*>(rhdl);
+	if (r->thread.joinable()) r->thread.join();
+	return ERT_CMD_STATE_COMPLETED;
+}
+
+int xrtRunClose(xrtRunHandle rhdl) {
+	xrtRunWait(rhdl);
+	delete static_cast<Run*>(rhdl);
+	return 0;
+}
+
+void adf::registerXRT(xrtDeviceHandle dhdl, const unsigned char*) {
+	twin::attach_device(device(dhdl));
+}
@@ -0,0 +1,50 @@
+import numpy as np
+
+# must match src/system_settings.h
+PQ_M = 64
+PQ_KSUB = 256
+PQ_BLOCK = 128
+PQ_NUM_BLOCKS = 16
+PQ_TOPK = 16
+
+
+def write_lut(file: str, lut: np.ndarray):
+    """uint8 table packed little-endian into one int32 stream word per line"""
+    words = lut.reshape(-1).view('<i4')
+    with open(file, 'w') as f:
+        for w in words:
+            f.write(f"{int(w)}\n")
+
+
+def write_codes(file: str, codes: np.ndarray):
+    """uint8 codes, four per 32-bit PLIO line"""
+    flat = codes.reshape(-1)
+    with open(file, 'w') as f:
+        for i in range(0, flat.size, 4):
+            f.write(" ".join(str(int(v)) for v in flat[i:i + 4]) + "\n")
+
+
+def main():
+    rng = np.random.default_rng(12262023)
+    num_vectors = PQ_BLOCK * PQ_NUM_BLOCKS
+
+    # quantized query table and corpus codes, as the host encoder emits them
+    lut = rng.integers(0, 256, size=(PQ_M, PQ_KSUB), dtype=np.uint8)
+    codes = rng.integers(0, PQ_KSUB, size=(num_vectors, PQ_M), dtype=np.uint8)
+
+    scores = lut[np.arange(PQ_M)[None, :], codes].astype(np.int64).sum(axis=1)
+    # stable sort keeps the lower id first on ties, like the kernel
+    order = np.argsort(-scores, kind='stable')[:PQ_TOPK]
+
+    write_lut('lut.txt', lut)
+    write_codes('codes.txt', codes)
+    with open('golden.txt', 'w') as f:
+        for i in order:
+            f.write(f"{int(scores[i])}\n")
+            f.write(f"{int(i)}\n")
+
+    print(f"Best score {int(scores[order[0]])} at vector {int(order[0])}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,65 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+
+#include <iostream>
+#include <fstream>
+#include "graph.hpp"
+
+pqGraph pq_graph;
+
+#if defined(__AIESIM__) || defined(__X86SIM__)
+int main(int argc, char** argv) {
+    pq_graph.init();
+    // one iteration per code window of the query
+    pq_graph.run(PQ_NUM_BLOCKS);
+    pq_graph.end();
+    std::ifstream golden_file, aie_file;
+    golden_file.open("../data/golden.txt");
+    if(golden_file.fail()){
+      std::cerr << "Error opening golden file." << std::endl;
+      golden_file.close();
+      return -1;
+    }
+
+#if defined(__X86SIM__)
+    aie_file.open("x86simulator_output/output.txt");
+#else
+    aie_file.open("aiesimulator_output/output.txt");
+#endif
+    if(aie_file.fail()){
+      std::cerr<<"Error opening produced file."<< std::endl;
+      return -1;
+    }
+
+    std::string line_golden, line_aie;
+    bool match = true;
+    while (getline(golden_file, line_golden)){
+        getline(aie_file, line_aie);
+        if (aie_file.eof()){
+            std::cerr << "AI Engine results are too short to match golden result" << std::endl;
+            match = false;
+            break;
+        }
+        while (line_aie[0]=='T')
+            getline(aie_file, line_aie);
+        if (std::stoi(line_golden) != std::stoi(line_aie)){
+            match = false;
+            break;
+        }
+    }
+    if (!aie_file.eof()){
+        getline(aie_file, line_aie);
+        if (!aie_file.eof())
+            std::cerr << "AI Engine results are too long to match golden result" << std::endl;
+    }
+    if (match)
+        std::cout << "AI Engine results match golden result" << std::endl;
+    else
+        std::cout << "AI Engine results DO NOT match golden result" << std::endl;
+
+    golden_file.close();
+    aie_file.close();
+    return 0;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,42 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef __GRAPH_H__
+#define __GRAPH_H__
+
+#include <adf.h>
+#include "kernels.hpp"
+
+using namespace adf;
+
+class pqGraph : public graph {
+    private:
+        kernel scan;
+
+    public:
+        input_plio p_lut;
+        input_plio p_codes;
+        output_plio p_out;
+
+        pqGraph() {
+            // create kernel & define source code
+            scan = kernel::create(pq_adc_scan);
+            source(scan) = "pq_adc_scan.cc";
+
+            // Define connection names and text file source/sink
+            p_lut = input_plio::create("StreamLut", plio_32_bits, "data/lut.txt");
+            p_codes = input_plio::create("StreamCodes", plio_32_bits, "data/codes.txt");
+            p_out = output_plio::create("StreamOut0", plio_32_bits, "output.txt");
+
+            // LUT once per query on a stream, codes in ping-pong windows
+            connect<stream>(p_lut.out[0], scan.in[0]);
+            connect(p_codes.out[0], scan.in[1]);
+            connect<stream>(scan.out[0], p_out.in[0]);
+
+            // Define kernel runtime ratio
+            runtime<ratio>(scan) = 1;
+        };
+};
+
+#endif /**********__GRAPH_H__**********/
@@ -0,0 +1,15 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+
+#ifndef __KERNELS_H__
+#define __KERNELS_H__
+
+#include <adf.h>
+#include "system_settings.h"
+
+void pq_adc_scan(input_stream<int32> *lut,
+                 adf::input_buffer_1d<uint8, NSAMPLES_WINDOW_PQ_CODES>& __restrict codes,
+                 output_stream<int32> *out);
+
+#endif /**********__KERNELS_H__**********/
@@ -0,0 +1,83 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+
+#include <adf.h>
+#include <aie_api/aie.hpp>
+#include <aie_api/aie_adf.hpp>
+#include "system_settings.h"
+
+// Lookup table of the query being scanned; loaded from the stream once per
+// query and reused for all PQ_NUM_BLOCKS code windows.
+alignas(32) static uint8 lut_buf[PQ_LUT_BYTES];
+
+void pq_adc_scan(input_stream<int32> *lut,
+                 adf::input_buffer_1d<uint8, NSAMPLES_WINDOW_PQ_CODES>& __restrict codes,
+                 output_stream<int32> *out){
+
+    static unsigned block = 0;
+    static int32 topScore[PQ_TOPK];
+    static int32 topId[PQ_TOPK];
+
+    if (block == 0) {
+        int32* dst = reinterpret_cast<int32*>(lut_buf);
+        for (unsigned i = 0; i < PQ_LUT_WORDS; i += 4)
+            chess_prepare_for_pipelining
+        {
+            aie::store_v(dst + i, readincr_v<4>(lut));
+        }
+        // table entries are unsigned, so -1 is below every score
+        for (unsigned k = 0; k < PQ_TOPK; ++k) {
+            topScore[k] = -1;
+            topId[k] = -1;
+        }
+    }
+
+    // AIE has no indexed vector load, so the PQ_M table lookups per vector
+    // are pipelined scalar loads. Scores are gathered L vectors at a time and
+    // compared against the K-th best in one vector op; most groups stop there.
+    constexpr unsigned L = 16;
+    const uint8* __restrict C = codes.data();
+    const int32 base = block * PQ_BLOCK;
+
+    for (unsigned v0 = 0; v0 < PQ_BLOCK; v0 += L) {
+        aie::vector<int32, L> acc;
+        for (unsigned l = 0; l < L; ++l) {
+            const uint8* __restrict code = C + (v0 + l) * PQ_M;
+            const uint8* __restrict T = lut_buf;
+            int32 s = 0;
+            for (unsigned m = 0; m < PQ_M; ++m)
+                chess_prepare_for_pipelining
+            {
+                s += T[code[m]];
+                T += PQ_KSUB;
+            }
+            acc.set(s, l);
+        }
+
+        if (aie::gt(acc, topScore[PQ_TOPK - 1]).empty())
+            continue;
+
+        for (unsigned l = 0; l < L; ++l) {
+            const int32 v = acc[l];
+            if (v <= topScore[PQ_TOPK - 1]) continue;
+            unsigned p = PQ_TOPK - 1;
+            while (p > 0 && topScore[p - 1] < v) {
+                topScore[p] = topScore[p - 1];
+                topId[p] = topId[p - 1];
+                --p;
+            }
+            topScore[p] = v;
+            topId[p] = base + v0 + l;
+        }
+    }
+
+    // Emit (score, id) pairs once the query's last block has been scanned
+    if (++block == PQ_NUM_BLOCKS) {
+        for (unsigned k = 0; k < PQ_TOPK; ++k) {
+            writeincr(out, topScore[k]);
+            writeincr(out, topId[k]);
+        }
+        block = 0;
+    }
+}
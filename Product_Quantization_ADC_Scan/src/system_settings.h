@@ -0,0 +1,24 @@
+// Copyright (C) 2023 Advanced Micro Devices, Inc
+//
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+/* Product-quantization ADC scan
+
+  Corpus vectors are PQ_M one-byte codes (768 dims / 64 subspaces = 12 dims
+  per sub-quantizer). Per query the host builds a PQ_M x PQ_KSUB lookup table
+  of inner products, quantized to uint8 so that PQ_M = 64 fits one tile
+  (16 KB). A vector's score is the sum of its PQ_M table entries.
+*/
+
+#define PQ_M 64
+#define PQ_KSUB 256
+#define PQ_BLOCK 128            // corpus vectors per code window
+#define PQ_NUM_BLOCKS 16        // code windows scanned per query
+#define PQ_TOPK 16
+
+// Window / stream sizes
+#define PQ_LUT_BYTES (PQ_M*PQ_KSUB)
+#define PQ_LUT_WORDS (PQ_LUT_BYTES/4)
+#define NSAMPLES_WINDOW_PQ_CODES (PQ_BLOCK*PQ_M)